@@ -0,0 +1,141 @@
+#ifndef BATCH_HEAP_H
+#define BATCH_HEAP_H
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "futex.h"
+#include "priority_queue.h"
+
+/**
+ *  BatchHeap class defines a min-heap updated in synchronous rounds of k
+ *  inserts and k removals whose work is split across a pool of threads.
+ *
+ *  <p>
+ *  The entries are spread over one PriorityQueue per thread. In a round the
+ *  inserts are dealt round robin to the parts, then every part removes its
+ *  smallest entries up to a quota, all in parallel. Because the entries are
+ *  spread evenly, each part holds about k/p of the k smallest, so the quota
+ *  only slightly exceeds k/p. The calling thread merges the parts' sorted
+ *  candidates, pulling more from a part in the rare case its candidates run
+ *  out, and the candidates not among the k smallest are reinserted into
+ *  their parts in parallel.
+ *  </p>
+ *
+ *  <p>
+ *  A round therefore costs O((k/p) log(n)) per thread for the heap
+ *  operations and O(k log(p)) on the calling thread for the merge, instead
+ *  of O(k log(n)) on one thread. The result is exact: removed entries are
+ *  the k smallest of the queue after the round's inserts.
+ *  </p>
+ *
+ *  <p>
+ *  A BatchHeap is driven by one thread at a time, that thread also works
+ *  on the first part.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the BatchHeap().
+ *    Key projection of T the heap is ordered by, defaults to Identity.
+ *    Tuning arity and prefetch distance of each part's heap.
+ *
+ *  Member Variables:\n
+ *    key projection of entries, shared with the parts.
+ *    parts one Part per thread.
+ *    workers the pool threads, working on parts 1 and above.
+ *    count number of entries.
+ *    next part the next insert is dealt to.
+ *    inserts, quota arguments of the current round, read by the phases.
+ *    phase the step the pool is running.
+ *    stopping set when the pool should exit.
+ *    start Futex bumped to start a phase.
+ *    pending number of pool threads still running the phase.
+ *    done Futex bumped by the last pool thread finishing a phase.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) start the pool.
+ *    - (Destructor) stop and join the pool.
+ *    - size() return the number of entries.
+ *    - threads() return the number of threads working in a round.
+ *    - round() insert a batch then remove the k smallest entries.
+ *    - run() private helper run a phase on every part in parallel.
+ *    - work() private helper body of a pool thread.
+ *    - insertPhase() private helper insert a part's share of a batch.
+ *    - takePhase() private helper remove a part's candidates.
+ *    - returnPhase() private helper reinsert a part's unused candidates.
+ *  </p>
+ */
+template <class T, class Key = Identity<T>,
+  class Tuning = PriorityQueueTuning<sizeof(T)> >
+class BatchHeap
+{
+  public:
+    explicit BatchHeap(size_t = std::thread::hardware_concurrency(),
+      const Key & = Key());
+    ~BatchHeap();
+    size_t size() const noexcept;
+    size_t threads() const noexcept;
+    void round(const std::vector<T> &, size_t, std::vector<T> &);
+
+  private:
+    /**
+     *  Part is one thread's heap and its candidates of the current round,
+     *  padded so neighbouring parts share no cache line.
+     */
+    struct Part
+    {
+      explicit Part(const Key &key) : queue(key), used(0) {}
+      char front[0x40];
+      PriorityQueue<T, Key, Tuning> queue;
+      std::vector<T> taken;
+      size_t used;
+      char back[0x40];
+    };
+
+    /**
+     *  Head is the next unused candidate of a part during the merge.
+     */
+    struct Head
+    {
+      const T *val;
+      size_t part;
+    };
+
+    /**
+     *  HeadKey orders Heads by the key of their candidate.
+     */
+    struct HeadKey
+    {
+      Key key;
+      typename std::decay<decltype(std::declval<const Key &>()(
+        std::declval<const T &>()))>::type operator()(const Head &h) const
+      {
+        return key(*h.val);
+      }
+    };
+
+    typedef void (BatchHeap::*Phase)(size_t);
+    void run(Phase);
+    void work(size_t);
+    void insertPhase(size_t);
+    void takePhase(size_t);
+    void returnPhase(size_t);
+    Key key;
+    std::vector<std::unique_ptr<Part> > parts;
+    std::vector<std::thread> workers;
+    size_t count;
+    size_t next;
+    const std::vector<T> *inserts;
+    size_t quota;
+    Phase phase;
+    bool stopping;
+    Futex start;
+    std::atomic<size_t> pending;
+    Futex done;
+};
+
+#include "batch_heap.hxx"
+#endif
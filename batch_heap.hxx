@@ -0,0 +1,281 @@
+#include <climits>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  The pool runs one phase at a time. The driving thread stores the phase
+ *  and its arguments, sets pending and bumps start, whose release ordering
+ *  publishes them to the pool. It then runs the phase on part 0 itself.
+ *  Each pool thread decrements pending when done, the last one bumps and
+ *  wakes done. Every thread only touches its own part inside a phase, so no
+ *  phase takes a lock.
+ *  </p>
+ *
+ *  <p>
+ *  The candidates taken from a part are a sorted prefix of it. If the merge
+ *  consumes all of a part's candidates while the part still has entries,
+ *  the next smallest entries of that part are not known to be larger than
+ *  the remaining candidates of the other parts, so the merge removes more
+ *  from that part itself before continuing. Only that part's candidate
+ *  vector grows, and its Head has already left the merge queue, so no Head
+ *  points into reallocated storage.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty BatchHeap and starts its pool.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of each part's heap.
+ *  @param threads number of threads working in a round, including the
+ *    calling thread, at least 1.
+ *  @param key projection of entries compared by the heap.
+ */
+template <class T, class Key, class Tuning>
+BatchHeap<T, Key, Tuning>::BatchHeap(size_t threads, const Key &key) :
+  key(key), count(0), next(0), inserts(NULL), quota(0), phase(NULL),
+  stopping(false), pending(0)
+{
+  threads = threads ? threads : 01;
+  for(size_t i = 0; i < threads; ++i)
+  {
+    parts.push_back(std::unique_ptr<Part>(new Part(key)));
+  }
+  for(size_t i = 01; i < threads; ++i)
+  {
+    workers.push_back(std::thread(&BatchHeap::work, this, i));
+  }
+}
+
+/**
+ *  @brief Stops and joins the pool, destroying the remaining entries.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of each part's heap.
+ */
+template <class T, class Key, class Tuning>
+BatchHeap<T, Key, Tuning>::~BatchHeap()
+{
+  stopping = true;
+  start.bump();
+  start.wake(INT_MAX);
+  for(size_t i = 0; i < workers.size(); ++i)
+  {
+    workers[i].join();
+  }
+}
+
+/**
+ *  @brief Returns the number of entries.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of each part's heap.
+ */
+template <class T, class Key, class Tuning>
+size_t BatchHeap<T, Key, Tuning>::size() const noexcept
+{
+  return count;
+}
+
+/**
+ *  @brief Returns the number of threads working in a round.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of each part's heap.
+ */
+template <class T, class Key, class Tuning>
+size_t BatchHeap<T, Key, Tuning>::threads() const noexcept
+{
+  return parts.size();
+}
+
+/**
+ *  @brief Inserts a batch of entries, then removes the k smallest entries.
+ *
+ *  Complexity:\n
+ *    O((b/p + k/p) log(n)) per thread and O(k log(p)) on the calling
+ *    thread, where b is the batch size, p is threads() and n is size().
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of each part's heap.
+ *  @param batch entries to insert, will be copied.
+ *  @param k number of entries to remove, fewer if size() becomes smaller.
+ *  @param out removed entries are appended to it in ascending order.
+ */
+template <class T, class Key, class Tuning>
+void BatchHeap<T, Key, Tuning>::round(const std::vector<T> &batch, size_t k,
+  std::vector<T> &out)
+{
+  const size_t p = parts.size();
+  if(!batch.empty())
+  {
+    inserts = &batch;
+    run(&BatchHeap::insertPhase);
+    next = (next + batch.size()) % p;
+    count += batch.size();
+  }
+  k = k < count ? k : count;
+  if(k == 0)
+  {
+    return;
+  }
+
+  quota = (k + p - 01) / p;
+  quota += quota / 02 + 01;
+  run(&BatchHeap::takePhase);
+
+  HeadKey headKey = {key};
+  PriorityQueue<Head, HeadKey> heads(headKey);
+  for(size_t i = 0; i < p; ++i)
+  {
+    if(!parts[i]->taken.empty())
+    {
+      Head h = {&parts[i]->taken[0], i};
+      heads.insert(h);
+    }
+  }
+  for(size_t removed = 0; removed < k; ++removed)
+  {
+    Head h = heads.removeMin();
+    Part &part = *parts[h.part];
+    out.push_back(*h.val);
+    if(++part.used == part.taken.size() && part.queue.size() != 0)
+    {
+      part.taken.push_back(part.queue.removeMin());
+    }
+    if(part.used != part.taken.size())
+    {
+      h.val = &part.taken[part.used];
+      heads.insert(h);
+    }
+  }
+  count -= k;
+
+  run(&BatchHeap::returnPhase);
+}
+
+/**
+ *  @brief Run a phase on every part, part 0 on the calling thread, and
+ *  return once all are done.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of each part's heap.
+ *  @param step the phase to run.
+ */
+template <class T, class Key, class Tuning>
+void BatchHeap<T, Key, Tuning>::run(Phase step)
+{
+  phase = step;
+  if(!workers.empty())
+  {
+    pending.store(workers.size(), std::memory_order_relaxed);
+    start.bump();
+    start.wake(INT_MAX);
+  }
+  (this->*step)(0);
+  for(;;)
+  {
+    unsigned seen = done.load();
+    if(pending.load(std::memory_order_acquire) == 0)
+    {
+      break;
+    }
+    done.wait(seen);
+  }
+}
+
+/**
+ *  @brief Body of a pool thread: run each started phase on one part.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of each part's heap.
+ *  @param i the part this thread works on.
+ */
+template <class T, class Key, class Tuning>
+void BatchHeap<T, Key, Tuning>::work(size_t i)
+{
+  unsigned seen = 0;
+  for(;;)
+  {
+    unsigned now;
+    while((now = start.load()) == seen)
+    {
+      start.wait(now);
+    }
+    seen = now;
+    if(stopping)
+    {
+      return;
+    }
+    (this->*phase)(i);
+    if(pending.fetch_sub(01, std::memory_order_acq_rel) == 01)
+    {
+      done.bump();
+      done.wake(01);
+    }
+  }
+}
+
+/**
+ *  @brief Insert the entries of the batch dealt to one part.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of each part's heap.
+ *  @param i the part.
+ */
+template <class T, class Key, class Tuning>
+void BatchHeap<T, Key, Tuning>::insertPhase(size_t i)
+{
+  const size_t p = parts.size();
+  Part &part = *parts[i];
+  for(size_t j = (i + p - next) % p; j < inserts->size(); j += p)
+  {
+    part.queue.insert((*inserts)[j]);
+  }
+}
+
+/**
+ *  @brief Remove up to quota of a part's smallest entries as candidates.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of each part's heap.
+ *  @param i the part.
+ */
+template <class T, class Key, class Tuning>
+void BatchHeap<T, Key, Tuning>::takePhase(size_t i)
+{
+  Part &part = *parts[i];
+  part.used = 0;
+  for(size_t n = 0; n < quota && part.queue.size() != 0; ++n)
+  {
+    part.taken.push_back(part.queue.removeMin());
+  }
+}
+
+/**
+ *  @brief Reinsert the candidates of a part the merge did not use.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of each part's heap.
+ *  @param i the part.
+ */
+template <class T, class Key, class Tuning>
+void BatchHeap<T, Key, Tuning>::returnPhase(size_t i)
+{
+  Part &part = *parts[i];
+  for(size_t j = part.used; j < part.taken.size(); ++j)
+  {
+    part.queue.insert(part.taken[j]);
+  }
+  part.taken.clear();
+}
@@ -0,0 +1,121 @@
+#ifndef BEAM_H
+#define BEAM_H
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "indexed_heap.h"
+#include "slot_table.h"
+
+/**
+ *  Beam class defines the candidate sets of a beam search: the current
+ *  beam being expanded, and the next beam keeping the best B expansions
+ *  offered, one distinct state each.
+ *
+ *  <p>
+ *  Candidates of the next beam sit in B fixed slots. An IndexedHeap orders
+ *  the slots worst first, so once the beam is full an expansion no better
+ *  than the worst is rejected by one comparison, and any other replaces
+ *  the worst in O(log(B)). Selecting B of n expansions thus costs
+ *  O(n log(B)) instead of the O(n log(n)) of queueing them all.
+ *  </p>
+ *
+ *  <p>
+ *  States are deduplicated by Hash and Equal, which usually look at the
+ *  state only, not at its score, through a SlotTable of the slots of the
+ *  next beam. A state offered again keeps the better of its two candidates,
+ *  updated in place. advance() swaps the two beams' arrays and clears the
+ *  table, so steps never allocate.
+ *  </p>
+ *
+ *  <p>
+ *  Lower keys are better, as in PriorityQueue; rank log probabilities by
+ *  their negation.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the candidates, default constructible.
+ *    Key projection of T candidates are ranked by, compared with <.
+ *    Hash hash of a candidate's state.
+ *    Equal whether two candidates have the same state.
+ *
+ *  Member Variables:\n
+ *    beamWidth B, the number of candidates kept.
+ *    current the current beam, currentSize candidates.
+ *    next the slots of the next beam, nextSize in use.
+ *    key projection of candidates.
+ *    hash, equal hash and equality of states.
+ *    worst IndexedHeap of the used slots of next, worst first.
+ *    states SlotTable of the used slots of next, by state.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor taking the beam width, optionally
+ *        the projection, hash and equality.
+ *    - width() return the beam width.
+ *    - size() return the number of candidates in the current beam.
+ *    - pending() return the number of candidates in the next beam.
+ *    - begin(), end() iterate over the current beam, unordered.
+ *    - sorted() copy the current beam, best first.
+ *    - offer() offer an expansion to the next beam.
+ *    - advance() make the next beam current and start an empty next beam.
+ *  </p>
+ */
+template <class T, class Key = Identity<T>, class Hash = std::hash<T>,
+  class Equal = std::equal_to<T> >
+class Beam
+{
+  public:
+    explicit Beam(size_t, const Key & = Key(), const Hash & = Hash(),
+      const Equal & = Equal());
+    Beam(const Beam &) = delete;
+    Beam &operator=(const Beam &) = delete;
+    size_t width() const noexcept;
+    size_t size() const noexcept;
+    size_t pending() const noexcept;
+    const T *begin() const noexcept;
+    const T *end() const noexcept;
+    void sorted(std::vector<T> &) const;
+    bool offer(const T &);
+    void advance() noexcept;
+
+  private:
+    typedef typename std::decay<decltype(std::declval<const Key &>()(
+      std::declval<const T &>()))>::type KeyType;
+
+    /**
+     *  Reversed is a key ordered backwards, making IndexedHeap a max-heap.
+     */
+    struct Reversed
+    {
+      KeyType key;
+      bool operator<(const Reversed &o) const { return o.key < key; }
+    };
+
+    /**
+     *  Worse projects a slot of the next beam to its reversed key.
+     */
+    struct Worse
+    {
+      const Beam *beam;
+      Reversed operator()(unsigned slot) const
+      {
+        Reversed r = {beam->key(beam->next[slot])};
+        return r;
+      }
+    };
+
+    size_t beamWidth;
+    std::vector<T> current;
+    size_t currentSize;
+    std::vector<T> next;
+    size_t nextSize;
+    Key key;
+    Hash hash;
+    Equal equal;
+    IndexedHeap<Worse> worst;
+    SlotTable states;
+};
+
+#include "beam.hxx"
+#endif
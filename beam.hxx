@@ -0,0 +1,211 @@
+#include <algorithm>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  The table of states holds slot numbers with the hash of their
+ *  candidates in next, and an expansion is matched against the candidates
+ *  of the slots sharing its hash. A slot's candidate is only replaced by
+ *  one of a different state after the slot has left the table, so the hash
+ *  kept for a slot is always that of its state.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs a Beam of a given width, with both beams empty.
+ *
+ *  @tparam T type of the candidates.
+ *  @tparam Key projection of T candidates are ranked by.
+ *  @tparam Hash hash of a candidate's state.
+ *  @tparam Equal whether two candidates have the same state.
+ *  @param width the number of candidates kept per step.
+ *  @param key projection of candidates compared.
+ *  @param hash hash of a candidate's state.
+ *  @param equal whether two candidates have the same state.
+ */
+template <class T, class Key, class Hash, class Equal>
+Beam<T, Key, Hash, Equal>::Beam(size_t width, const Key &key,
+  const Hash &hash, const Equal &equal) :
+  beamWidth(width), current(width), currentSize(0), next(width),
+  nextSize(0), key(key), hash(hash), equal(equal), worst(Worse{this}),
+  states(width)
+{
+  worst.reserve(width);
+}
+
+/**
+ *  @brief Returns the number of candidates kept per step.
+ *
+ *  @tparam T type of the candidates.
+ *  @tparam Key projection of T candidates are ranked by.
+ *  @tparam Hash hash of a candidate's state.
+ *  @tparam Equal whether two candidates have the same state.
+ */
+template <class T, class Key, class Hash, class Equal>
+size_t Beam<T, Key, Hash, Equal>::width() const noexcept
+{
+  return beamWidth;
+}
+
+/**
+ *  @brief Returns the number of candidates in the current beam.
+ *
+ *  @tparam T type of the candidates.
+ *  @tparam Key projection of T candidates are ranked by.
+ *  @tparam Hash hash of a candidate's state.
+ *  @tparam Equal whether two candidates have the same state.
+ */
+template <class T, class Key, class Hash, class Equal>
+size_t Beam<T, Key, Hash, Equal>::size() const noexcept
+{
+  return currentSize;
+}
+
+/**
+ *  @brief Returns the number of candidates in the next beam so far.
+ *
+ *  @tparam T type of the candidates.
+ *  @tparam Key projection of T candidates are ranked by.
+ *  @tparam Hash hash of a candidate's state.
+ *  @tparam Equal whether two candidates have the same state.
+ */
+template <class T, class Key, class Hash, class Equal>
+size_t Beam<T, Key, Hash, Equal>::pending() const noexcept
+{
+  return nextSize;
+}
+
+/**
+ *  @brief Returns the first candidate of the current beam, in no
+ *  particular order.
+ *
+ *  @tparam T type of the candidates.
+ *  @tparam Key projection of T candidates are ranked by.
+ *  @tparam Hash hash of a candidate's state.
+ *  @tparam Equal whether two candidates have the same state.
+ */
+template <class T, class Key, class Hash, class Equal>
+const T *Beam<T, Key, Hash, Equal>::begin() const noexcept
+{
+  return current.data();
+}
+
+/**
+ *  @brief Returns one past the last candidate of the current beam.
+ *
+ *  @tparam T type of the candidates.
+ *  @tparam Key projection of T candidates are ranked by.
+ *  @tparam Hash hash of a candidate's state.
+ *  @tparam Equal whether two candidates have the same state.
+ */
+template <class T, class Key, class Hash, class Equal>
+const T *Beam<T, Key, Hash, Equal>::end() const noexcept
+{
+  return current.data() + currentSize;
+}
+
+/**
+ *  @brief Copies the current beam, best first.
+ *
+ *  Complexity:\n
+ *    O(B log(B)) where B is size().
+ *
+ *  @tparam T type of the candidates.
+ *  @tparam Key projection of T candidates are ranked by.
+ *  @tparam Hash hash of a candidate's state.
+ *  @tparam Equal whether two candidates have the same state.
+ *  @param out replaced by the candidates.
+ */
+template <class T, class Key, class Hash, class Equal>
+void Beam<T, Key, Hash, Equal>::sorted(std::vector<T> &out) const
+{
+  out.assign(begin(), end());
+  const Key &k = key;
+  std::sort(out.begin(), out.end(), [&k](const T &a, const T &b)
+  {
+    return k(a) < k(b);
+  });
+}
+
+/**
+ *  @brief Offers an expansion to the next beam.
+ *
+ *  It is kept if its state is new and the beam has room or a worse
+ *  candidate to evict, or if its state is there with a worse candidate,
+ *  which it replaces.
+ *
+ *  Complexity:\n
+ *    Constant when rejected for being no better than the worst of a full
+ *    beam. Otherwise one hash lookup and O(log(B)) where B is width(),
+ *    without allocating.
+ *
+ *  @tparam T type of the candidates.
+ *  @tparam Key projection of T candidates are ranked by.
+ *  @tparam Hash hash of a candidate's state.
+ *  @tparam Equal whether two candidates have the same state.
+ *  @param val the expansion, copied if kept.
+ *  @return whether the expansion was kept.
+ */
+template <class T, class Key, class Hash, class Equal>
+bool Beam<T, Key, Hash, Equal>::offer(const T &val)
+{
+  bool full = nextSize == beamWidth;
+  if(beamWidth == 0 || (full && !(key(val) < key(next[worst.top()]))))
+  {
+    return false;
+  }
+
+  size_t h = hash(val);
+  unsigned slot = states.find(h, [this, &val](unsigned s)
+  {
+    return equal(next[s], val);
+  });
+  if(slot != SlotTable::absent)
+  {
+    if(!(key(val) < key(next[slot])))
+    {
+      return false;
+    }
+    next[slot] = val;
+    worst.update(slot);
+    return true;
+  }
+
+  if(full)
+  {
+    slot = worst.top();
+    states.erase(hash(next[slot]), slot);
+    next[slot] = val;
+    worst.update(slot);
+  }
+  else
+  {
+    slot = nextSize++;
+    next[slot] = val;
+    worst.push(slot);
+  }
+  states.insert(h, slot);
+  return true;
+}
+
+/**
+ *  @brief Makes the next beam current, discarding the current one, and
+ *  starts an empty next beam.
+ *
+ *  Complexity:\n
+ *    O(B) where B is width(), without allocating.
+ *
+ *  @tparam T type of the candidates.
+ *  @tparam Key projection of T candidates are ranked by.
+ *  @tparam Hash hash of a candidate's state.
+ *  @tparam Equal whether two candidates have the same state.
+ */
+template <class T, class Key, class Hash, class Equal>
+void Beam<T, Key, Hash, Equal>::advance() noexcept
+{
+  current.swap(next);
+  currentSize = nextSize;
+  nextSize = 0;
+  worst.clear();
+  states.clear();
+}
@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include "delta_stepping.h"
+
+/**
+ *  bench_delta_stepping times single source shortest paths on a generated
+ *  graph with Dijkstra's algorithm and with DeltaStepping, and checks that
+ *  both find the same distances.
+ *
+ *  <p>
+ *  Usage: bench_delta_stepping [vertices [degree [threads]]]\n
+ *  The graph has the given number of vertices, by default 2^22, each with
+ *  degree edges, by default 8, to uniformly random vertices, with weights
+ *  uniform in [0, 1). This is the random graph model delta-stepping was
+ *  analysed on, and delta is set to 1/degree. Threads defaults to the
+ *  number of cpus.
+ *  </p>
+ */
+
+/**
+ *  @brief Returns the milliseconds elapsed since a time point.
+ */
+static double since(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+  unsigned n = argc > 01 ? std::strtoul(argv[01], NULL, 0) : 01 << 22;
+  size_t degree = argc > 02 ? std::strtoul(argv[02], NULL, 0) : 010;
+  size_t threads = argc > 03 ? std::strtoul(argv[03], NULL, 0) :
+    std::thread::hardware_concurrency();
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> weight(0, 1);
+  Graph g;
+  g.offsets.reserve(n + 01);
+  g.targets.reserve(n * degree);
+  g.weights.reserve(n * degree);
+  for(unsigned v = 0; v < n; ++v)
+  {
+    g.offsets.push_back(g.targets.size());
+    for(size_t i = 0; i < degree; ++i)
+    {
+      g.targets.push_back(gen() % n);
+      g.weights.push_back(weight(gen));
+    }
+  }
+  g.offsets.push_back(g.targets.size());
+
+  std::vector<double> expected, got;
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  dijkstra(g, 0, expected);
+  double sequential = since(start);
+
+  DeltaStepping engine(g, 1.0 / degree, threads);
+  start = std::chrono::steady_clock::now();
+  engine.run(0, got);
+  double parallel = since(start);
+
+  size_t mismatches = 0;
+  for(unsigned v = 0; v < n; ++v)
+  {
+    if(std::fabs(got[v] - expected[v]) > 1e-9 * (1 + expected[v]) &&
+      got[v] != expected[v])
+    {
+      ++mismatches;
+    }
+  }
+  std::printf("%u vertices, %zu edges\n", n, g.targets.size());
+  std::printf("dijkstra:       %.1f ms\n", sequential);
+  std::printf("delta-stepping: %.1f ms on %zu threads\n", parallel, threads);
+  std::printf("%zu mismatched distances\n", mismatches);
+  return mismatches != 0;
+}
@@ -0,0 +1,138 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "knn.h"
+#include "priority_queue.h"
+
+/**
+ *  bench_knn times brute force k-nearest-neighbour queries done the usual
+ *  way, with scalar distances and a PriorityQueue of (distance, id) pairs
+ *  under an inverted key, against KnnIndex.
+ *
+ *  <p>
+ *  Usage: bench_knn [vectors] [dim]\n
+ *  Vectors and queries are uniformly random. Each configuration runs the
+ *  same queries for k of 1, 10 and 100 and reports the best of three runs
+ *  per query.
+ *  </p>
+ */
+
+/**
+ *  Inverted ranks (distance, id) pairs in descending order, turning the
+ *  min-heap into a max-heap.
+ */
+struct Inverted
+{
+  std::pair<float, int> operator()(const std::pair<float, int> &p) const
+  {
+    return std::make_pair(-p.first, -p.second);
+  }
+};
+
+static const int repeats = 3;
+
+/**
+ *  @brief Query with scalar distances and a PriorityQueue, pushing every
+ *  candidate and popping the farthest once there are more than k.
+ */
+static void baseline(const std::vector<float> &vectors, size_t dim,
+  const float *query, size_t k, std::vector<Neighbor> &out)
+{
+  PriorityQueue<std::pair<float, int>, Inverted> q;
+  for(size_t i = 0; i < vectors.size() / dim; ++i)
+  {
+    const float *row = &vectors[i * dim];
+    float sum = 0;
+    for(size_t j = 0; j < dim; ++j)
+    {
+      sum += (query[j] - row[j]) * (query[j] - row[j]);
+    }
+    q.insert(std::make_pair(sum, (int)i));
+    if(q.size() > k)
+    {
+      q.removeMin();
+    }
+  }
+  out.resize(q.size());
+  for(size_t i = q.size(); i > 0; --i)
+  {
+    std::pair<float, int> p = q.removeMin();
+    Neighbor n = {p.first, (unsigned)p.second};
+    out[i - 01] = n;
+  }
+}
+
+/**
+ *  @brief Time a query function over every query.
+ *
+ *  @return microseconds per query, best of repeats.
+ */
+template <class Query>
+double run(const std::vector<float> &queries, size_t dim, Query query)
+{
+  double best = 0;
+  std::vector<Neighbor> out;
+  for(int r = 0; r < repeats; ++r)
+  {
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    for(size_t i = 0; i < queries.size(); i += dim)
+    {
+      query(&queries[i], out);
+    }
+    double us = std::chrono::duration<double, std::micro>(
+      std::chrono::steady_clock::now() - start).count() /
+      (queries.size() / dim);
+    if(r == 0 || us < best)
+    {
+      best = us;
+    }
+  }
+  return best;
+}
+
+int main(int argc, char **argv)
+{
+  size_t n = argc > 01 ? std::strtoul(argv[01], NULL, 0) : 01 << 17;
+  size_t dim = argc > 02 ? std::strtoul(argv[02], NULL, 0) : 0x80;
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> uniform(0, 1);
+  std::vector<float> vectors(n * dim), queries(0x10 * dim);
+  for(size_t i = 0; i < vectors.size(); ++i)
+  {
+    vectors[i] = uniform(gen);
+  }
+  for(size_t i = 0; i < queries.size(); ++i)
+  {
+    queries[i] = uniform(gen);
+  }
+  KnnIndex<> index(vectors.data(), n, dim);
+  unsigned threads = std::thread::hardware_concurrency();
+
+  static const size_t ks[] = {01, 012, 0144};
+  for(size_t i = 0; i < sizeof(ks) / sizeof(*ks); ++i)
+  {
+    size_t k = ks[i];
+    double a = run(queries, dim,
+      [&](const float *q, std::vector<Neighbor> &out)
+      {
+        baseline(vectors, dim, q, k, out);
+      });
+    double b = run(queries, dim,
+      [&](const float *q, std::vector<Neighbor> &out)
+      {
+        index.search(q, k, out);
+      });
+    double c = run(queries, dim,
+      [&](const float *q, std::vector<Neighbor> &out)
+      {
+        index.search(q, k, out, threads ? threads : 01);
+      });
+    std::printf("k %3zu: PriorityQueue %8.0f us, KnnIndex %8.0f us, "
+      "%u threads %8.0f us\n", k, a, b, threads, c);
+  }
+}
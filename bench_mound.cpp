@@ -0,0 +1,295 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "concurrent_queue.h"
+#include "mound.h"
+
+/**
+ *  bench_mound compares the throughput of Mound with a lock-free skiplist
+ *  priority queue and with ConcurrentPriorityQueue, a PriorityQueue behind
+ *  a mutex.
+ *
+ *  <p>
+ *  Usage: bench_mound [ops [entries]]\n
+ *  Each queue is filled with entries, by default 2^16, then every thread
+ *  runs ops operations, by default 2^20 split evenly over the threads, each
+ *  an insert or a removal with equal probability. Thread counts double from
+ *  1 up to twice the number of cpus, so a 64 thread box covers 1 to 128.
+ *  </p>
+ */
+
+/**
+ *  SkipQueue is the lock-free skiplist priority queue of Herlihy and Shavit:
+ *  a lock-free skiplist whose removeMin() walks the bottom level and claims
+ *  the first unclaimed node with compare and swap, then unlinks it by
+ *  marking its next pointers. Keys must be unique and between 1 and
+ *  UINT64_MAX - 1.
+ *
+ *  <p>
+ *  Nodes are only freed with the queue, which is fine for a benchmark and
+ *  sidesteps safe memory reclamation.
+ *  </p>
+ */
+class SkipQueue
+{
+  public:
+    SkipQueue();
+    ~SkipQueue();
+    void insert(uint64_t);
+    bool tryRemoveMin(uint64_t &);
+
+  private:
+    static const int maxLevel = 0x14;
+    struct Node
+    {
+      uint64_t key;
+      int top;
+      std::atomic<bool> claimed;
+      std::atomic<uintptr_t> next[maxLevel];
+    };
+    static Node *ptr(uintptr_t p) { return reinterpret_cast<Node *>(p & ~01); }
+    static bool marked(uintptr_t p) { return p & 01; }
+    Node *make(uint64_t, int);
+    bool find(uint64_t, Node **, Node **);
+    Node head;
+    Node tail;
+    std::mutex lock;
+    std::vector<Node *> nodes;
+};
+
+inline SkipQueue::SkipQueue()
+{
+  head.key = 0;
+  tail.key = UINT64_MAX;
+  head.top = tail.top = maxLevel - 01;
+  for(int l = 0; l < maxLevel; ++l)
+  {
+    head.next[l].store(reinterpret_cast<uintptr_t>(&tail));
+    tail.next[l].store(0);
+  }
+}
+
+inline SkipQueue::~SkipQueue()
+{
+  for(size_t i = 0; i < nodes.size(); ++i)
+  {
+    delete nodes[i];
+  }
+}
+
+/**
+ *  @brief Allocate a node, remembering it to be freed with the queue.
+ */
+inline SkipQueue::Node *SkipQueue::make(uint64_t key, int top)
+{
+  Node *n = new Node;
+  n->key = key;
+  n->top = top;
+  n->claimed.store(false, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> guard(lock);
+  nodes.push_back(n);
+  return n;
+}
+
+/**
+ *  @brief Find the predecessors and successors of a key on every level,
+ *  unlinking marked nodes on the way.
+ *
+ *  @return whether a node with the key is linked on the bottom level.
+ */
+inline bool SkipQueue::find(uint64_t key, Node **preds, Node **succs)
+{
+retry:
+  Node *pred = &head;
+  Node *curr = NULL;
+  for(int l = maxLevel - 01; l >= 0; --l)
+  {
+    curr = ptr(pred->next[l].load());
+    for(;;)
+    {
+      uintptr_t succ = curr->next[l].load();
+      while(marked(succ))
+      {
+        uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+        if(!pred->next[l].compare_exchange_strong(expected, succ & ~01))
+        {
+          goto retry;
+        }
+        curr = ptr(succ);
+        succ = curr->next[l].load();
+      }
+      if(curr->key >= key)
+      {
+        break;
+      }
+      pred = curr;
+      curr = ptr(succ);
+    }
+    preds[l] = pred;
+    succs[l] = curr;
+  }
+  return curr->key == key;
+}
+
+/**
+ *  @brief Link a new node on the bottom level, then on the levels above
+ *  up to its random height.
+ */
+inline void SkipQueue::insert(uint64_t key)
+{
+  static thread_local std::minstd_rand random(
+    std::hash<std::thread::id>()(std::this_thread::get_id()));
+  int top = 0;
+  while(top < maxLevel - 01 && random() & 01)
+  {
+    ++top;
+  }
+  Node *preds[maxLevel];
+  Node *succs[maxLevel];
+  Node *n = make(key, top);
+  for(;;)
+  {
+    if(find(key, preds, succs))
+    {
+      return;
+    }
+    for(int l = 0; l <= top; ++l)
+    {
+      n->next[l].store(reinterpret_cast<uintptr_t>(succs[l]));
+    }
+    uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+    if(preds[0]->next[0].compare_exchange_strong(expected,
+      reinterpret_cast<uintptr_t>(n)))
+    {
+      break;
+    }
+  }
+  for(int l = 01; l <= top; ++l)
+  {
+    for(;;)
+    {
+      uintptr_t next = n->next[l].load();
+      uintptr_t succ = reinterpret_cast<uintptr_t>(succs[l]);
+      if(marked(next) ||
+        (next != succ && !n->next[l].compare_exchange_strong(next, succ)))
+      {
+        if(marked(n->next[l].load()))
+        {
+          return;
+        }
+        continue;
+      }
+      if(preds[l]->next[l].compare_exchange_strong(succ,
+        reinterpret_cast<uintptr_t>(n)))
+      {
+        break;
+      }
+      find(key, preds, succs);
+    }
+  }
+}
+
+/**
+ *  @brief Claim the first unclaimed node of the bottom level, mark its next
+ *  pointers top down and let find() unlink it.
+ */
+inline bool SkipQueue::tryRemoveMin(uint64_t &out)
+{
+  Node *curr = ptr(head.next[0].load());
+  while(curr != &tail)
+  {
+    bool unclaimed = false;
+    if(!curr->claimed.load(std::memory_order_relaxed) &&
+      curr->claimed.compare_exchange_strong(unclaimed, true))
+    {
+      for(int l = curr->top; l >= 0; --l)
+      {
+        uintptr_t next = curr->next[l].load();
+        while(!marked(next) &&
+          !curr->next[l].compare_exchange_weak(next, next | 01))
+        {
+        }
+      }
+      Node *preds[maxLevel];
+      Node *succs[maxLevel];
+      find(curr->key, preds, succs);
+      out = curr->key;
+      return true;
+    }
+    curr = ptr(curr->next[0].load());
+  }
+  return false;
+}
+
+/**
+ *  @brief Time ops operations split over a number of threads on a queue
+ *  prefilled with entries.
+ *
+ *  @return millions of operations per second.
+ */
+template <class Queue>
+double run(size_t threads, size_t ops, size_t entries)
+{
+  Queue q;
+  std::mt19937_64 gen(0);
+  for(size_t i = 0; i < entries; ++i)
+  {
+    q.insert((gen() >> 0x18) << 010 | 0xff);
+  }
+  std::atomic<bool> go(false);
+  std::vector<std::thread> pool;
+  for(size_t t = 0; t < threads; ++t)
+  {
+    pool.push_back(std::thread([&q, &go, t, threads, ops]()
+    {
+      std::mt19937_64 gen(t + 01);
+      uint64_t out;
+      while(!go.load())
+      {
+      }
+      for(size_t i = 0; i < ops / threads; ++i)
+      {
+        uint64_t r = gen();
+        if(r & 01)
+        {
+          q.insert((r >> 0x18) << 010 | t % 0xff);
+        }
+        else
+        {
+          q.tryRemoveMin(out);
+        }
+      }
+    }));
+  }
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  go.store(true);
+  for(size_t t = 0; t < threads; ++t)
+  {
+    pool[t].join();
+  }
+  double us = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - start).count();
+  return ops / us;
+}
+
+int main(int argc, char **argv)
+{
+  size_t ops = argc > 01 ? std::strtoul(argv[01], NULL, 0) : 01 << 20;
+  size_t entries = argc > 02 ? std::strtoul(argv[02], NULL, 0) : 01 << 16;
+  size_t cpus = std::thread::hardware_concurrency();
+  std::printf("threads     mound  skiplist     mutex  (Mops/s)\n");
+  for(size_t t = 01; t <= 02 * (cpus ? cpus : 01); t *= 02)
+  {
+    std::printf("%7zu %9.2f %9.2f %9.2f\n", t,
+      run<Mound<uint64_t> >(t, ops, entries),
+      run<SkipQueue>(t, ops, entries),
+      run<ConcurrentPriorityQueue<uint64_t> >(t, ops, entries));
+  }
+}
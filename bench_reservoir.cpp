@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+#include "priority_queue.h"
+#include "weighted_reservoir.h"
+
+/**
+ *  bench_reservoir times weighted sampling of k items from a stream with
+ *  A-Res over a PriorityQueue, drawing a key and doing a heap operation per
+ *  item, against WeightedReservoir, which skips ahead with exponential
+ *  jumps.
+ *
+ *  <p>
+ *  Usage: bench_reservoir [items] [k]\n
+ *  Weights are drawn up front, uniformly from 1 to 16, so only sampling is
+ *  timed.
+ *  </p>
+ */
+
+/**
+ *  @brief Sample with one key and one heap operation per item.
+ */
+static void baseline(const std::vector<float> &weights, size_t k,
+  std::vector<unsigned> &out)
+{
+  std::mt19937_64 gen(0);
+  std::uniform_real_distribution<double> u(0, 1);
+  PriorityQueue<std::pair<double, unsigned> > q;
+  for(unsigned i = 0; i < weights.size(); ++i)
+  {
+    q.insert(std::make_pair(std::pow(u(gen), 1 / weights[i]), i));
+    if(q.size() > k)
+    {
+      q.removeMin();
+    }
+  }
+  out.clear();
+  while(q.size() != 0)
+  {
+    out.push_back(q.removeMin().second);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  size_t n = argc > 01 ? std::strtoul(argv[01], NULL, 0) : 01 << 24;
+  size_t k = argc > 02 ? std::strtoul(argv[02], NULL, 0) : 0x400;
+  std::mt19937 gen(01);
+  std::vector<float> weights(n);
+  for(size_t i = 0; i < n; ++i)
+  {
+    weights[i] = gen() % 0x10 + 01;
+  }
+
+  std::vector<unsigned> out;
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  baseline(weights, k, out);
+  double a = std::chrono::duration<double, std::nano>(
+    std::chrono::steady_clock::now() - start).count() / n;
+
+  start = std::chrono::steady_clock::now();
+  WeightedReservoir<unsigned> r(k);
+  for(unsigned i = 0; i < n; ++i)
+  {
+    r.offer(i, weights[i]);
+  }
+  r.sample(out);
+  double b = std::chrono::duration<double, std::nano>(
+    std::chrono::steady_clock::now() - start).count() / n;
+
+  std::printf("%zu items, k %zu: PriorityQueue A-Res %.1f ns/item, "
+    "WeightedReservoir %.1f ns/item, %llu heap entries\n", n, k, a, b,
+    r.entries());
+}
@@ -0,0 +1,66 @@
+#ifndef BLOCKING_QUEUE_H
+#define BLOCKING_QUEUE_H
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include "futex.h"
+#include "priority_queue.h"
+
+/**
+ *  BlockingPriorityQueue class defines a thread safe min-heap whose consumers
+ *  sleep until entries are available.
+ *
+ *  <p>
+ *  Entries are kept in a PriorityQueue behind a mutex. Consumers that find it
+ *  empty register as waiters and sleep on a Futex. push() wakes exactly one
+ *  consumer, and only when one is registered, so producers pay no system
+ *  call while consumers keep up and a single entry never wakes a herd.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the BlockingPriorityQueue().
+ *    Tuning arity and prefetch distance of the heap.
+ *
+ *  Member Variables:\n
+ *    lock mutex guarding queue and waiters.
+ *    queue PriorityQueue holding the entries.
+ *    waiters number of consumers registered to sleep.
+ *    ready Futex bumped by producers to wake consumers.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor.
+ *    - size() return the number of entries.
+ *    - push() insert a new entry, waking one waiting consumer.
+ *    - pop() remove the minimum entry, blocking while empty.
+ *    - tryPop() remove the minimum entry if there is one.
+ *    - popUntil() remove the minimum entry, blocking at most until a
+ *        deadline.
+ *    - popN() remove up to n entries, blocking while empty.
+ *    - waitForEntry() private helper block until non-empty or a deadline.
+ *  </p>
+ */
+template <class T, class Tuning = PriorityQueueTuning<sizeof(T)> >
+class BlockingPriorityQueue
+{
+  public:
+    BlockingPriorityQueue();
+    size_t size();
+    void push(T);
+    T pop();
+    bool tryPop(T &);
+    template <class Clock, class Duration>
+    bool popUntil(T &, const std::chrono::time_point<Clock, Duration> &);
+    size_t popN(std::vector<T> &, size_t);
+
+  private:
+    bool waitForEntry(std::unique_lock<std::mutex> &,
+      const std::chrono::steady_clock::time_point *);
+    std::mutex lock;
+    PriorityQueue<T, Identity<T>, Tuning> queue;
+    size_t waiters;
+    Futex ready;
+};
+
+#include "blocking_queue.hxx"
+#endif
@@ -0,0 +1,200 @@
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  A consumer reads the Futex value while holding the lock, after seeing the
+ *  queue empty, and sleeps on that value after releasing the lock. A
+ *  producer inserts and reads waiters under the same lock, then bumps the
+ *  Futex before waking. Whatever the interleaving, the consumer either sees
+ *  the bumped value and does not sleep, or is asleep when the wake arrives.
+ *  </p>
+ *
+ *  <p>
+ *  A woken consumer may find the entry already taken by a consumer that
+ *  never slept, it then simply waits again. A consumer whose deadline
+ *  passes rechecks the queue before giving up, so an entry pushed while it
+ *  was timing out is not left behind.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty BlockingPriorityQueue.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Tuning>
+BlockingPriorityQueue<T, Tuning>::BlockingPriorityQueue() : waiters(0)
+{
+}
+
+/**
+ *  @brief Returns the number of entries.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Tuning>
+size_t BlockingPriorityQueue<T, Tuning>::size()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  return queue.size();
+}
+
+/**
+ *  @brief Inserts a new entry and wakes one waiting consumer, if any.
+ *
+ *  Complexity:\n
+ *    O(log(n)) amortized, where n is size(), plus one futex wake when a
+ *    consumer is waiting.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param val new object to be stored, will be copied.
+ */
+template <class T, class Tuning>
+void BlockingPriorityQueue<T, Tuning>::push(T val)
+{
+  bool wake;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    queue.insert(val);
+    wake = waiters != 0;
+  }
+  if(wake)
+  {
+    ready.bump();
+    ready.wake(01);
+  }
+}
+
+/**
+ *  @brief Removes the minimum entry, blocking while the queue is empty.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size(), once an entry is available.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @return T the minimum entry.
+ */
+template <class T, class Tuning>
+T BlockingPriorityQueue<T, Tuning>::pop()
+{
+  std::unique_lock<std::mutex> guard(lock);
+  waitForEntry(guard, NULL);
+  return queue.removeMin();
+}
+
+/**
+ *  @brief Removes the minimum entry if there is one, without blocking.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param out set to the removed entry.
+ *  @return false if the queue was empty.
+ */
+template <class T, class Tuning>
+bool BlockingPriorityQueue<T, Tuning>::tryPop(T &out)
+{
+  std::lock_guard<std::mutex> guard(lock);
+  if(queue.size() == 0)
+  {
+    return false;
+  }
+  out = queue.removeMin();
+  return true;
+}
+
+/**
+ *  @brief Removes the minimum entry, blocking at most until a deadline.
+ *
+ *  Deadlines of clocks other than steady_clock are converted to it once on
+ *  entry.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Clock clock the deadline is measured on.
+ *  @tparam Duration duration type of the deadline.
+ *  @param out set to the removed entry.
+ *  @param deadline time to give up at.
+ *  @return false if the deadline passed with the queue still empty.
+ */
+template <class T, class Tuning>
+template <class Clock, class Duration>
+bool BlockingPriorityQueue<T, Tuning>::popUntil(T &out,
+  const std::chrono::time_point<Clock, Duration> &deadline)
+{
+  std::chrono::steady_clock::time_point steady =
+    std::chrono::steady_clock::now() +
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      deadline - Clock::now());
+  std::unique_lock<std::mutex> guard(lock);
+  if(!waitForEntry(guard, &steady))
+  {
+    return false;
+  }
+  out = queue.removeMin();
+  return true;
+}
+
+/**
+ *  @brief Removes up to n entries in ascending order, blocking while the
+ *  queue is empty.
+ *
+ *  Takes the lock once for the whole batch.
+ *
+ *  Complexity:\n
+ *    O(k log(n)) where k is the number of entries removed.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param out removed entries are appended to it.
+ *  @param n maximum number of entries to remove, at least 1.
+ *  @return the number of entries removed.
+ */
+template <class T, class Tuning>
+size_t BlockingPriorityQueue<T, Tuning>::popN(std::vector<T> &out, size_t n)
+{
+  std::unique_lock<std::mutex> guard(lock);
+  waitForEntry(guard, NULL);
+  size_t taken = 0;
+  for(; taken < n && queue.size() != 0; ++taken)
+  {
+    out.push_back(queue.removeMin());
+  }
+  return taken;
+}
+
+/**
+ *  @brief Block until the queue is non-empty. Must hold lock.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param guard held lock, released while sleeping.
+ *  @param deadline time to give up at, NULL to wait forever.
+ *  @return false if the deadline passed with the queue still empty.
+ */
+template <class T, class Tuning>
+bool BlockingPriorityQueue<T, Tuning>::waitForEntry(
+  std::unique_lock<std::mutex> &guard,
+  const std::chrono::steady_clock::time_point *deadline)
+{
+  bool inTime = true;
+  while(queue.size() == 0 && inTime)
+  {
+    unsigned seen = ready.load();
+    ++waiters;
+    guard.unlock();
+    if(deadline)
+    {
+      inTime = ready.waitUntil(seen, *deadline);
+    }
+    else
+    {
+      ready.wait(seen);
+    }
+    guard.lock();
+    --waiters;
+  }
+  return queue.size() != 0;
+}
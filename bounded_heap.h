@@ -0,0 +1,86 @@
+#ifndef BOUNDED_HEAP_H
+#define BOUNDED_HEAP_H
+#include <vector>
+#include "priority_queue.h"
+
+/**
+ *  BoundedHeap class keeps the n least entries offered to it, the top-k
+ *  selection at the core of nearest neighbour search and beam search.
+ *
+ *  <p>
+ *  Entries are kept in a max-heap, so the greatest kept entry, the one the
+ *  next accepted entry evicts, is at the root. Once the heap is full an
+ *  entry that is not less than the root is rejected by a single comparison
+ *  without touching the heap, which is what most offers do when k is small
+ *  relative to the stream. An accepted entry replaces the root and is
+ *  sifted down once, instead of a removeMin() and insert() pair on a
+ *  PriorityQueue with an inverted comparison.
+ *  </p>
+ *
+ *  <p>
+ *  Room for the limit is allocated up front, so offering, clearing and
+ *  swapping never allocate.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the BoundedHeap().
+ *    Key projection of T the entries are ranked by, compared with <.
+ *    Tuning arity of the heap.
+ *
+ *  Member Variables:\n
+ *    heap entries in max-heap order, with a filler at position 0.
+ *    bound the number of entries kept.
+ *    key projection of entries compared by the heap.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor taking the limit, optionally the
+ *        projection.
+ *    - size() return the number of entries.
+ *    - limit() return the number of entries kept.
+ *    - full() return whether size() reached limit().
+ *    - worst() return the greatest kept entry.
+ *    - accepts() return whether an entry would be kept, in O(1).
+ *    - offer() keep an entry if it is among the least seen.
+ *    - merge() offer every entry of another BoundedHeap.
+ *    - begin(), end() iterate over the entries in heap order.
+ *    - drain() move the entries out in ascending order.
+ *    - clear() remove every entry, keeping the allocation.
+ *    - swap() exchange contents with another BoundedHeap.
+ *    - less() private helper compare two entries by key.
+ *    - up(), down() private helpers sift a position towards the root or the
+ *        leaves.
+ *  </p>
+ */
+template <class T, class Key = Identity<T>,
+  class Tuning = PriorityQueueTuning<sizeof(T)> >
+class BoundedHeap
+{
+  public:
+    explicit BoundedHeap(size_t, const Key & = Key());
+    size_t size() const noexcept;
+    size_t limit() const noexcept;
+    bool full() const noexcept;
+    const T &worst() const noexcept;
+    bool accepts(const T &) const;
+    bool offer(const T &);
+    void merge(const BoundedHeap &);
+    const T *begin() const noexcept;
+    const T *end() const noexcept;
+    void drain(std::vector<T> &);
+    void clear() noexcept;
+    void swap(BoundedHeap &) noexcept;
+
+  private:
+    static const size_t arity = Tuning::arity;
+    static_assert(Tuning::arity >= 02, "a heap needs at least two children");
+    inline bool less(const T &, const T &) const;
+    void up(size_t);
+    void down(size_t);
+    std::vector<T> heap;
+    size_t bound;
+    Key key;
+};
+
+#include "bounded_heap.hxx"
+#endif
@@ -0,0 +1,322 @@
+#include <utility>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  The layout follows PriorityQueue: 1-based, children of position n at
+ *  d(n-1)+2 through dn+1, with the order reversed so the root is the
+ *  greatest entry. Sifting moves a hole rather than swapping.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty BoundedHeap keeping at most n entries.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ *  @param n the number of entries kept.
+ *  @param key projection of entries compared by the heap.
+ */
+template <class T, class Key, class Tuning>
+BoundedHeap<T, Key, Tuning>::BoundedHeap(size_t n, const Key &key) :
+  heap(01), bound(n), key(key)
+{
+  heap.reserve(n + 01);
+}
+
+/**
+ *  @brief Returns the number of entries.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class T, class Key, class Tuning>
+size_t BoundedHeap<T, Key, Tuning>::size() const noexcept
+{
+  return heap.size() - 01;
+}
+
+/**
+ *  @brief Returns the number of entries kept.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class T, class Key, class Tuning>
+size_t BoundedHeap<T, Key, Tuning>::limit() const noexcept
+{
+  return bound;
+}
+
+/**
+ *  @brief Returns whether the heap holds limit() entries, so offers start
+ *  evicting.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class T, class Key, class Tuning>
+bool BoundedHeap<T, Key, Tuning>::full() const noexcept
+{
+  return size() >= bound;
+}
+
+/**
+ *  @brief Returns the greatest kept entry, e.g. the k-th nearest neighbour
+ *  so far.
+ *
+ *  Precondition:\n
+ *    size() > 0
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class T, class Key, class Tuning>
+const T &BoundedHeap<T, Key, Tuning>::worst() const noexcept
+{
+  return heap[01];
+}
+
+/**
+ *  @brief Returns whether offer() would keep an entry.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ *  @param val the entry.
+ */
+template <class T, class Key, class Tuning>
+bool BoundedHeap<T, Key, Tuning>::accepts(const T &val) const
+{
+  return !full() || (bound != 0 && less(val, heap[01]));
+}
+
+/**
+ *  @brief Keeps an entry if it is less than the greatest kept entry or the
+ *  heap is not full, evicting the greatest in the first case.
+ *
+ *  Complexity:\n
+ *    Constant when rejected, O(d log(k)/log(d)) otherwise, where k is
+ *    limit() and d is the arity.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ *  @param val the entry, copied if kept.
+ *  @return whether the entry was kept.
+ */
+template <class T, class Key, class Tuning>
+bool BoundedHeap<T, Key, Tuning>::offer(const T &val)
+{
+  if(!full())
+  {
+    heap.push_back(val);
+    up(size());
+    return true;
+  }
+  if(bound == 0 || !less(val, heap[01]))
+  {
+    return false;
+  }
+  heap[01] = val;
+  down(01);
+  return true;
+}
+
+/**
+ *  @brief Offers every entry of another BoundedHeap, e.g. one filled by
+ *  another thread over another part of the input.
+ *
+ *  Complexity:\n
+ *    O(m d log(k)/log(d)) where m is other.size(), less when most of its
+ *    entries are rejected.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ *  @param other the heap merged in, unchanged.
+ */
+template <class T, class Key, class Tuning>
+void BoundedHeap<T, Key, Tuning>::merge(const BoundedHeap &other)
+{
+  for(const T *i = other.begin(); i != other.end(); ++i)
+  {
+    offer(*i);
+  }
+}
+
+/**
+ *  @brief Returns the first entry, in heap order.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class T, class Key, class Tuning>
+const T *BoundedHeap<T, Key, Tuning>::begin() const noexcept
+{
+  return heap.data() + 01;
+}
+
+/**
+ *  @brief Returns one past the last entry, in heap order.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class T, class Key, class Tuning>
+const T *BoundedHeap<T, Key, Tuning>::end() const noexcept
+{
+  return heap.data() + heap.size();
+}
+
+/**
+ *  @brief Moves the entries out in ascending order and empties the heap.
+ *
+ *  The greatest entry is repeatedly removed and stored from the back of
+ *  the output, so no extra sort is needed.
+ *
+ *  Complexity:\n
+ *    O(k d log(k)/log(d)) where k is size() and d is the arity.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ *  @param out replaced by the entries, least first.
+ */
+template <class T, class Key, class Tuning>
+void BoundedHeap<T, Key, Tuning>::drain(std::vector<T> &out)
+{
+  out.resize(size());
+  for(size_t i = size(); i > 0; --i)
+  {
+    out[i - 01] = heap[01];
+    heap[01] = heap.back();
+    heap.pop_back();
+    if(size() > 01)
+    {
+      down(01);
+    }
+  }
+}
+
+/**
+ *  @brief Removes every entry, keeping the allocation.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class T, class Key, class Tuning>
+void BoundedHeap<T, Key, Tuning>::clear() noexcept
+{
+  heap.resize(01);
+}
+
+/**
+ *  @brief Exchanges entries, limits and projections with another
+ *  BoundedHeap without copying entries or allocating.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ *  @param other the other heap.
+ */
+template <class T, class Key, class Tuning>
+void BoundedHeap<T, Key, Tuning>::swap(BoundedHeap &other) noexcept
+{
+  heap.swap(other.heap);
+  std::swap(bound, other.bound);
+  std::swap(key, other.key);
+}
+
+/**
+ *  @brief Compare two entries by key.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ *  @param a the left entry.
+ *  @param b the right entry.
+ *  @return key(a) < key(b).
+ */
+template <class T, class Key, class Tuning>
+inline bool BoundedHeap<T, Key, Tuning>::less(const T &a, const T &b) const
+{
+  return key(a) < key(b);
+}
+
+/**
+ *  @brief Sift the entry at a position towards the root while it is
+ *  greater than its parent.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ *  @param pos the position.
+ */
+template <class T, class Key, class Tuning>
+void BoundedHeap<T, Key, Tuning>::up(size_t pos)
+{
+  T val = heap[pos];
+  while(pos > 01)
+  {
+    size_t parent = (pos + arity - 02) / arity;
+    if(!less(heap[parent], val))
+    {
+      break;
+    }
+    heap[pos] = heap[parent];
+    pos = parent;
+  }
+  heap[pos] = val;
+}
+
+/**
+ *  @brief Sift the entry at a position towards the leaves, always
+ *  descending to the greatest child.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the entries are ranked by.
+ *  @tparam Tuning arity of the heap.
+ *  @param pos the position.
+ */
+template <class T, class Key, class Tuning>
+void BoundedHeap<T, Key, Tuning>::down(size_t pos)
+{
+  T val = heap[pos];
+  size_t n = size();
+  for(;;)
+  {
+    size_t first = arity * (pos - 01) + 02;
+    if(first > n)
+    {
+      break;
+    }
+    size_t last = first + arity - 01 <= n ? first + arity - 01 : n;
+    size_t greatest = first;
+    for(size_t c = first + 01; c <= last; ++c)
+    {
+      if(less(heap[greatest], heap[c]))
+      {
+        greatest = c;
+      }
+    }
+    if(!less(val, heap[greatest]))
+    {
+      break;
+    }
+    heap[pos] = heap[greatest];
+    pos = greatest;
+  }
+  heap[pos] = val;
+}
@@ -0,0 +1,147 @@
+#ifndef BRANCH_AND_BOUND_H
+#define BRANCH_AND_BOUND_H
+#include <cstdio>
+#include <vector>
+#include "priority_queue.h"
+
+/**
+ *  BranchAndBound class defines a best-first branch and bound driver for
+ *  minimization problems, whose open list is kept within a memory cap.
+ *
+ *  <p>
+ *  Open nodes wait in a PriorityQueue ordered by their lower bound, cached
+ *  next to each node so it is computed once. The node of least bound is
+ *  expanded next: a complete node becomes the incumbent if it is better,
+ *  otherwise its children are queued unless their bound is no better than
+ *  the incumbent. Whenever the incumbent improves, every open node it makes
+ *  useless is dropped at once with PriorityQueue::removeIf(), instead of
+ *  lingering until it reaches the top.
+ *  </p>
+ *
+ *  <p>
+ *  Without a cap the open list grows with the frontier of the search tree,
+ *  which on hard instances exhausts memory. When it holds maxOpen nodes,
+ *  the driver either
+ *  </p>
+ *  <ul>
+ *    <li>dives, expanding new children depth-first from a stack until that
+ *      subtree is exhausted. The stack only holds the siblings along one
+ *      path, and diving tends to find incumbents that prune the open list.
+ *      </li>
+ *    <li>or spills, moving the back half of the heap to a temporary file.
+ *      Those entries are leaves of the heap, so each has an ancestor in
+ *      memory whose bound is no worse. Spilled nodes are read back, pruned
+ *      against the incumbent, once the open list runs empty. Nodes and
+ *      bounds are written bytewise, so both must be trivially copyable.
+ *      </li>
+ *  </ul>
+ *
+ *  Template Parameters:\n
+ *    Problem Type describing the search, with:\n
+ *      Node, a search tree node.\n
+ *      Bound, a lower bound on the objective, compared with <.\n
+ *      Bound bound(const Node &), the lower bound of a node, the objective
+ *        itself for complete nodes.\n
+ *      bool complete(const Node &), whether a node is a feasible solution.\n
+ *      void branch(const Node &, std::vector<Node> &), append the children
+ *        of an incomplete node.
+ *
+ *  Member Variables:\n
+ *    problem the problem searched.
+ *    maxOpen the cap on the number of open nodes.
+ *    overflow what to do when the cap is reached.
+ *    open the open list.
+ *    stack nodes waiting to be dived into.
+ *    children scratch space for branch().
+ *    best the incumbent, valid when found.
+ *    found whether there is an incumbent.
+ *    spill temporary file of spilled nodes, NULL until used.
+ *    spilledNodes number of nodes currently in spill.
+ *    stats counters of the last solve().
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) take the problem, and optionally the cap and overflow
+ *        policy.
+ *    - (Destructor) close the spill file.
+ *    - solve() search from a root node, return whether a solution exists.
+ *    - incumbent() return the best solution found.
+ *    - incumbentBound() return the objective of the incumbent.
+ *    - statistics() return counters of the last solve().
+ *    - expand() private helper expand or accept a node.
+ *    - enqueue() private helper queue a child, diving or spilling when the
+ *        open list is full.
+ *    - dive() private helper search depth-first from the stack.
+ *    - improve() private helper take a new incumbent and prune.
+ *    - prunable() private helper return whether a bound cannot improve on
+ *        the incumbent.
+ *    - spillOut() private helper move half the open list to disk.
+ *    - spillIn() private helper read spilled nodes back.
+ *  </p>
+ */
+template <class Problem>
+class BranchAndBound
+{
+  public:
+    typedef typename Problem::Node Node;
+    typedef typename Problem::Bound Bound;
+
+    /**
+     *  Overflow is what to do when the open list reaches its cap.
+     */
+    enum Overflow { depthFirst, spillToDisk };
+
+    /**
+     *  Statistics counts the work done by a solve().
+     */
+    struct Statistics
+    {
+      size_t expanded;
+      size_t pruned;
+      size_t improved;
+      size_t dived;
+      size_t spilled;
+      size_t peakOpen;
+    };
+
+    explicit BranchAndBound(Problem &, size_t = ~(size_t)0,
+      Overflow = depthFirst);
+    ~BranchAndBound();
+    BranchAndBound(const BranchAndBound &) = delete;
+    BranchAndBound &operator=(const BranchAndBound &) = delete;
+    bool solve(const Node &);
+    const Node &incumbent() const noexcept;
+    const Bound &incumbentBound() const noexcept;
+    const Statistics &statistics() const noexcept;
+
+  private:
+    /**
+     *  Open is a node with its cached bound.
+     */
+    struct Open
+    {
+      Bound bound;
+      Node node;
+    };
+    void expand(const Open &);
+    void enqueue(const Open &);
+    void dive();
+    void improve(const Open &);
+    bool prunable(const Bound &) const;
+    void spillOut();
+    void spillIn();
+    Problem &problem;
+    size_t maxOpen;
+    Overflow overflow;
+    PriorityQueue<Open, MemberKey<Open, Bound> > open;
+    std::vector<Open> stack;
+    std::vector<Node> children;
+    Open best;
+    bool found;
+    std::FILE *spill;
+    size_t spilledNodes;
+    Statistics stats;
+};
+
+#include "branch_and_bound.hxx"
+#endif
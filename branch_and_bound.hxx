@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  The spill file is used as a stack of Open records: spillOut() appends
+ *  and spillIn() reads from the end, then truncates what it read. This
+ *  keeps the file as large as the nodes currently spilled and never
+ *  rewrites records in place.
+ *  </p>
+ *
+ *  <p>
+ *  While diving, every child goes to the stack, even if the open list has
+ *  room again, so a dive runs to the end of its subtree. Siblings are
+ *  pushed worst first so the best is expanded next.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs a driver for a problem.
+ *
+ *  @tparam Problem type describing the search.
+ *  @param problem the problem, referenced during solve().
+ *  @param maxOpen cap on the number of open nodes kept in memory.
+ *  @param overflow what to do when the open list reaches the cap.
+ *  @throws std::invalid_argument if asked to spill nodes or bounds that
+ *    are not trivially copyable.
+ */
+template <class Problem>
+BranchAndBound<Problem>::BranchAndBound(Problem &problem, size_t maxOpen,
+  Overflow overflow) :
+  problem(problem), maxOpen(maxOpen), overflow(overflow),
+  open(memberKey(&Open::bound)), best(), found(false), spill(NULL),
+  spilledNodes(0), stats()
+{
+  if(overflow == spillToDisk && !std::is_trivially_copyable<Open>::value)
+  {
+    throw std::invalid_argument("spilled nodes must be trivially copyable");
+  }
+}
+
+/**
+ *  @brief Destructs the driver, deleting the spill file.
+ *
+ *  @tparam Problem type describing the search.
+ */
+template <class Problem>
+BranchAndBound<Problem>::~BranchAndBound()
+{
+  if(spill)
+  {
+    std::fclose(spill);
+  }
+}
+
+/**
+ *  @brief Searches the tree below a root node for a solution of least
+ *  objective.
+ *
+ *  Complexity:\n
+ *    Exponential in general, bounded by the number of nodes whose bound is
+ *    below the optimum, plus those expanded in dives.
+ *
+ *  @tparam Problem type describing the search.
+ *  @param root the root of the search tree.
+ *  @return whether any complete node was found.
+ *  @throws std::system_error if the spill file cannot be written or read.
+ */
+template <class Problem>
+bool BranchAndBound<Problem>::solve(const Node &root)
+{
+  open.removeIf([](const Open &) { return true; });
+  stack.clear();
+  found = false;
+  stats = Statistics();
+  if(spill && ftruncate(fileno(spill), 0) != 0)
+  {
+    throw std::system_error(errno, std::system_category(), "ftruncate");
+  }
+  spilledNodes = 0;
+
+  Open start = {problem.bound(root), root};
+  enqueue(start);
+  dive();
+  while(open.size() != 0 || spilledNodes != 0)
+  {
+    if(open.size() == 0)
+    {
+      spillIn();
+      continue;
+    }
+    Open next = open.removeMin();
+    if(prunable(next.bound))
+    {
+      ++stats.pruned;
+      continue;
+    }
+    expand(next);
+    dive();
+  }
+  return found;
+}
+
+/**
+ *  @brief Returns the best solution found.
+ *
+ *  Precondition:\n
+ *    the last solve() returned true.
+ *
+ *  @tparam Problem type describing the search.
+ */
+template <class Problem>
+const typename BranchAndBound<Problem>::Node &
+  BranchAndBound<Problem>::incumbent() const noexcept
+{
+  return best.node;
+}
+
+/**
+ *  @brief Returns the objective of the best solution found.
+ *
+ *  Precondition:\n
+ *    the last solve() returned true.
+ *
+ *  @tparam Problem type describing the search.
+ */
+template <class Problem>
+const typename BranchAndBound<Problem>::Bound &
+  BranchAndBound<Problem>::incumbentBound() const noexcept
+{
+  return best.bound;
+}
+
+/**
+ *  @brief Returns counters of the last solve().
+ *
+ *  @tparam Problem type describing the search.
+ */
+template <class Problem>
+const typename BranchAndBound<Problem>::Statistics &
+  BranchAndBound<Problem>::statistics() const noexcept
+{
+  return stats;
+}
+
+/**
+ *  @brief Accept a complete node or queue the children of an incomplete
+ *  one that may still beat the incumbent.
+ *
+ *  @tparam Problem type describing the search.
+ *  @param node the node, not prunable.
+ */
+template <class Problem>
+void BranchAndBound<Problem>::expand(const Open &node)
+{
+  ++stats.expanded;
+  if(problem.complete(node.node))
+  {
+    improve(node);
+    return;
+  }
+  children.clear();
+  problem.branch(node.node, children);
+  size_t first = stack.size();
+  for(size_t i = 0; i < children.size(); ++i)
+  {
+    Open child = {problem.bound(children[i]), children[i]};
+    if(prunable(child.bound))
+    {
+      ++stats.pruned;
+      continue;
+    }
+    enqueue(child);
+  }
+  std::sort(stack.begin() + first, stack.end(),
+    [](const Open &a, const Open &b) { return b.bound < a.bound; });
+}
+
+/**
+ *  @brief Queue a node on the open list, or on the stack while diving or
+ *  when the open list is full, spilling first if so configured.
+ *
+ *  @tparam Problem type describing the search.
+ *  @param node the node.
+ */
+template <class Problem>
+void BranchAndBound<Problem>::enqueue(const Open &node)
+{
+  if(!stack.empty() || open.size() >= maxOpen)
+  {
+    if(overflow == depthFirst || maxOpen < 02)
+    {
+      ++stats.dived;
+      stack.push_back(node);
+      return;
+    }
+    spillOut();
+  }
+  open.insert(node);
+  stats.peakOpen = std::max(stats.peakOpen, open.size());
+}
+
+/**
+ *  @brief Expand the nodes on the stack depth-first until it is empty.
+ *
+ *  @tparam Problem type describing the search.
+ */
+template <class Problem>
+void BranchAndBound<Problem>::dive()
+{
+  while(!stack.empty())
+  {
+    Open next = stack.back();
+    stack.pop_back();
+    if(prunable(next.bound))
+    {
+      ++stats.pruned;
+      continue;
+    }
+    expand(next);
+  }
+}
+
+/**
+ *  @brief Take a complete node as the incumbent if it is better, and drop
+ *  every open node that cannot beat it.
+ *
+ *  Complexity:\n
+ *    O(n) where n is the number of open nodes, when the incumbent improves.
+ *
+ *  @tparam Problem type describing the search.
+ *  @param node the complete node.
+ */
+template <class Problem>
+void BranchAndBound<Problem>::improve(const Open &node)
+{
+  if(prunable(node.bound))
+  {
+    return;
+  }
+  best = node;
+  found = true;
+  ++stats.improved;
+  const Bound &bound = best.bound;
+  stats.pruned += open.removeIf([&bound](const Open &o)
+  {
+    return !(o.bound < bound);
+  });
+}
+
+/**
+ *  @brief Returns whether a bound cannot improve on the incumbent.
+ *
+ *  @tparam Problem type describing the search.
+ *  @param bound the bound.
+ */
+template <class Problem>
+bool BranchAndBound<Problem>::prunable(const Bound &bound) const
+{
+  return found && !(bound < best.bound);
+}
+
+/**
+ *  @brief Move the back half of the open list to the spill file.
+ *
+ *  If a write fails the nodes not written stay in memory and
+ *  std::system_error is thrown.
+ *
+ *  Complexity:\n
+ *    O(n) where n is the number of open nodes.
+ *
+ *  @tparam Problem type describing the search.
+ */
+template <class Problem>
+void BranchAndBound<Problem>::spillOut()
+{
+  if(!spill && !(spill = std::tmpfile()))
+  {
+    throw std::system_error(errno, std::system_category(), "tmpfile");
+  }
+  if(std::fseek(spill, 0, SEEK_END) != 0)
+  {
+    throw std::system_error(errno, std::system_category(), "fseek");
+  }
+  size_t keep = open.size() - open.size() / 02;
+  size_t seen = 0;
+  int error = 0;
+  std::FILE *out = spill;
+  size_t written = open.removeIf([&](const Open &o)
+  {
+    if(++seen <= keep || error)
+    {
+      return false;
+    }
+    if(std::fwrite(&o, sizeof(o), 01, out) != 01)
+    {
+      error = errno ? errno : EIO;
+      return false;
+    }
+    return true;
+  });
+  spilledNodes += written;
+  stats.spilled += written;
+  if(error || std::fflush(spill) != 0)
+  {
+    throw std::system_error(error ? error : errno, std::system_category(),
+      "spill");
+  }
+}
+
+/**
+ *  @brief Read spilled nodes back, the most recently spilled first, until
+ *  the open list is half full or the file is empty. Nodes that can no
+ *  longer beat the incumbent are dropped.
+ *
+ *  @tparam Problem type describing the search.
+ */
+template <class Problem>
+void BranchAndBound<Problem>::spillIn()
+{
+  const size_t room = maxOpen / 02;
+  Open buffer[0x40];
+  while(spilledNodes != 0 && open.size() < room)
+  {
+    size_t n = std::min(std::min(spilledNodes, room - open.size()),
+      sizeof(buffer) / sizeof(*buffer));
+    size_t from = spilledNodes - n;
+    if(std::fseek(spill, from * sizeof(Open), SEEK_SET) != 0 ||
+      std::fread(buffer, sizeof(Open), n, spill) != n)
+    {
+      throw std::system_error(errno ? errno : EIO, std::system_category(),
+        "unspill");
+    }
+    spilledNodes = from;
+    for(size_t i = 0; i < n; ++i)
+    {
+      if(prunable(buffer[i].bound))
+      {
+        ++stats.pruned;
+        continue;
+      }
+      open.insert(buffer[i]);
+    }
+  }
+  stats.peakOpen = std::max(stats.peakOpen, open.size());
+  if(std::fflush(spill) != 0 ||
+    ftruncate(fileno(spill), spilledNodes * sizeof(Open)) != 0)
+  {
+    throw std::system_error(errno, std::system_category(), "ftruncate");
+  }
+}
@@ -0,0 +1,194 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <unistd.h>
+#include "priority_queue.h"
+
+/**
+ *  calibrate runs microbenchmarks of PriorityQueue on the current host and
+ *  writes a header of PriorityQueueTuning specializations, one per entry size,
+ *  holding the fastest arity and prefetch distance found.
+ *
+ *  <p>
+ *  Usage: calibrate [entries] > tuning.h\n
+ *  Then build with -DPRIORITY_QUEUE_TUNING='"tuning.h"'.
+ *  </p>
+ *
+ *  <p>
+ *  Each candidate is timed on the hold model: the queue is filled with
+ *  entries, then repeatedly the minimum is removed and a slightly larger
+ *  entry inserted. This keeps the size constant so every operation walks the
+ *  full height of the heap. The best of several runs is kept to filter out
+ *  noise from other processes.
+ *  </p>
+ */
+
+/**
+ *  Entry is a heap entry of Size bytes, ordered by its leading key. The
+ *  padding stands in for the payload of real entries.
+ */
+template <size_t Size>
+struct Entry
+{
+  unsigned key;
+  char pad[Size - sizeof(unsigned)];
+  bool operator<(const Entry &o) const { return key < o.key; }
+};
+
+template <>
+struct Entry<sizeof(unsigned)>
+{
+  unsigned key;
+  bool operator<(const Entry &o) const { return key < o.key; }
+};
+
+/**
+ *  Sweep is the tuning of a single candidate configuration.
+ */
+template <size_t Arity, size_t Prefetch>
+struct Sweep
+{
+  static const size_t arity = Arity;
+  static const size_t prefetch = Prefetch;
+};
+
+/**
+ *  Candidate is one point of the sweep and the function that times it.
+ */
+struct Candidate
+{
+  size_t arity;
+  size_t prefetch;
+  double (*run)(size_t, size_t);
+};
+
+static const int repeats = 3;
+
+/**
+ *  @brief Time the hold model for a PriorityQueue of Entry<Size> with the
+ *  given arity and prefetch distance.
+ *
+ *  @param n number of entries kept in the queue.
+ *  @param ops number of removeMin() and insert() pairs to time.
+ *
+ *  @return nanoseconds per pair, best of repeats runs.
+ */
+template <size_t Size, size_t Arity, size_t Prefetch>
+double run(size_t n, size_t ops)
+{
+  double best = 0;
+  for(int r = 0; r < repeats; ++r)
+  {
+    std::mt19937 gen(r);
+    PriorityQueue<Entry<Size>, Identity<Entry<Size> >,
+      Sweep<Arity, Prefetch> > q;
+    Entry<Size> e;
+    std::memset(&e, 0, sizeof(e));
+    for(size_t i = 0; i < n; ++i)
+    {
+      e.key = gen() >> 01;
+      q.insert(e);
+    }
+
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    for(size_t i = 0; i < ops; ++i)
+    {
+      e = q.removeMin();
+      e.key += gen() & 0xffff;
+      q.insert(e);
+    }
+    double ns = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count() / ops;
+    if(r == 0 || ns < best)
+    {
+      best = ns;
+    }
+  }
+  return best;
+}
+
+/**
+ *  @brief Sweep every candidate for entries of Size bytes and print the
+ *  specialization of the best one.
+ *
+ *  @param n number of entries kept in the queue.
+ *  @param ops number of operations timed per candidate.
+ */
+template <size_t Size>
+void sweep(size_t n, size_t ops)
+{
+  static const Candidate candidates[] =
+  {
+    {02, 0, &run<Size, 02, 0>}, {02, 01, &run<Size, 02, 01>},
+    {02, 02, &run<Size, 02, 02>},
+    {04, 0, &run<Size, 04, 0>}, {04, 01, &run<Size, 04, 01>},
+    {04, 02, &run<Size, 04, 02>},
+    {010, 0, &run<Size, 010, 0>}, {010, 01, &run<Size, 010, 01>},
+    {010, 02, &run<Size, 010, 02>},
+    {020, 0, &run<Size, 020, 0>}, {020, 01, &run<Size, 020, 01>},
+  };
+  const Candidate *best = candidates;
+  double bestNs = 0;
+  for(const Candidate *c = candidates;
+    c != candidates + sizeof(candidates) / sizeof(*candidates); ++c)
+  {
+    double ns = c->run(n, ops);
+    std::fprintf(stderr, "size %zu arity %zu prefetch %zu: %.1f ns\n", Size,
+      c->arity, c->prefetch, ns);
+    if(c == candidates || ns < bestNs)
+    {
+      best = c;
+      bestNs = ns;
+    }
+  }
+  std::printf("template <>\nstruct PriorityQueueTuning<%zu>\n{\n"
+    "  static const size_t arity = %zu;\n"
+    "  static const size_t prefetch = %zu;\n};\n\n",
+    Size, best->arity, best->prefetch);
+}
+
+/**
+ *  @brief Print a comment naming the host and cpu the tuning was made on.
+ */
+static void printHost()
+{
+  char host[0x100] = "unknown";
+  char model[0x100] = "unknown";
+  gethostname(host, sizeof(host) - 01);
+  if(FILE *f = std::fopen("/proc/cpuinfo", "r"))
+  {
+    char line[0x200];
+    while(std::fgets(line, sizeof(line), f))
+    {
+      const char *colon = std::strchr(line, ':');
+      if(colon && !std::strncmp(line, "model name", 10))
+      {
+        std::snprintf(model, sizeof(model), "%s", colon + 02);
+        model[std::strcspn(model, "\n")] = '\0';
+        break;
+      }
+    }
+    std::fclose(f);
+  }
+  std::printf("// Generated by calibrate on %s (%s), do not edit.\n", host,
+    model);
+}
+
+int main(int argc, char **argv)
+{
+  size_t n = argc > 01 ? std::strtoul(argv[01], NULL, 0) : 01 << 20;
+  size_t ops = n;
+
+  printHost();
+  std::printf("#ifndef PRIORITY_QUEUE_TUNING_GENERATED_H\n"
+    "#define PRIORITY_QUEUE_TUNING_GENERATED_H\n\n");
+  sweep<04>(n, ops);
+  sweep<010>(n, ops);
+  sweep<020>(n, ops);
+  sweep<040>(n, ops);
+  sweep<0100>(n, ops);
+  std::printf("#endif\n");
+}
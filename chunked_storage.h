@@ -0,0 +1,65 @@
+#ifndef CHUNKED_STORAGE_H
+#define CHUNKED_STORAGE_H
+#include <memory>
+#include <vector>
+
+/**
+ *  ChunkedStorage class defines a copy-on-write array for use as the Storage
+ *  of a PriorityQueue, making copies of the queue cheap.
+ *
+ *  <p>
+ *  Entries are held in fixed size chunks owned through reference counted
+ *  pointers. Copying a ChunkedStorage copies the chunk pointers only, so it
+ *  costs O(n/Chunk). Writing an entry through the non-const operator[]
+ *  first copies its chunk if another ChunkedStorage still shares it. A
+ *  PriorityQueue only writes the entries on the sift path of insert() and
+ *  removeMin(), so copies that diverge slightly keep sharing nearly all
+ *  chunks.
+ *  </p>
+ *
+ *  <p>
+ *  As with PersistentHeap, distinct copies may be used from different
+ *  threads, one ChunkedStorage object may not.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored.
+ *    Chunk number of entries per chunk, by default as many as fit in 4KiB.
+ *
+ *  Member Variables:\n
+ *    chunks the chunks, all full except possibly the last.
+ *    count number of entries.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) construct n value-initialized entries.
+ *    - size() return the number of entries.
+ *    - operator[] access an entry, unsharing its chunk if non-const.
+ *    - push_back() append an entry.
+ *    - pop_back() remove the last entry.
+ *    - sharedChunks() return how many chunks are shared with other copies.
+ *    - own() private helper unshare a chunk before writing to it.
+ *  </p>
+ */
+template <class T,
+  size_t Chunk = (0x1000 / sizeof(T) ? 0x1000 / sizeof(T) : 01)>
+class ChunkedStorage
+{
+  public:
+    explicit ChunkedStorage(size_t = 0);
+    size_t size() const noexcept;
+    const T &operator[](size_t) const noexcept;
+    T &operator[](size_t);
+    void push_back(const T &);
+    void pop_back();
+    size_t sharedChunks() const noexcept;
+
+  private:
+    typedef std::vector<T> Block;
+    Block &own(size_t);
+    std::vector<std::shared_ptr<Block> > chunks;
+    size_t count;
+};
+
+#include "chunked_storage.hxx"
+#endif
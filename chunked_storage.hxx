@@ -0,0 +1,161 @@
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  Each chunk is a std::vector reserved to Chunk entries, so push_back() and
+ *  pop_back() on the last chunk never reallocate it. A use count of 1 means
+ *  this ChunkedStorage is the only owner, nobody else can obtain a reference
+ *  except by copying this very object, so writing in place is safe.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs a ChunkedStorage of n value-initialized entries.
+ *
+ *  Complexity:\n
+ *    O(n).
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Chunk number of entries per chunk.
+ *  @param n initial number of entries.
+ */
+template <class T, size_t Chunk>
+ChunkedStorage<T, Chunk>::ChunkedStorage(size_t n) : count(0)
+{
+  for(size_t i = 0; i < n; ++i)
+  {
+    push_back(T());
+  }
+}
+
+/**
+ *  @brief Returns the number of entries.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Chunk number of entries per chunk.
+ */
+template <class T, size_t Chunk>
+size_t ChunkedStorage<T, Chunk>::size() const noexcept
+{
+  return count;
+}
+
+/**
+ *  @brief Read an entry without unsharing its chunk.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Chunk number of entries per chunk.
+ *  @param i index of the entry.
+ */
+template <class T, size_t Chunk>
+const T &ChunkedStorage<T, Chunk>::operator[](size_t i) const noexcept
+{
+  return (*chunks[i / Chunk])[i % Chunk];
+}
+
+/**
+ *  @brief Access an entry for writing, copying its chunk first if it is
+ *  shared.
+ *
+ *  Complexity:\n
+ *    O(Chunk) when the chunk is shared, constant otherwise.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Chunk number of entries per chunk.
+ *  @param i index of the entry.
+ */
+template <class T, size_t Chunk>
+T &ChunkedStorage<T, Chunk>::operator[](size_t i)
+{
+  return own(i / Chunk)[i % Chunk];
+}
+
+/**
+ *  @brief Append an entry.
+ *
+ *  Complexity:\n
+ *    O(1) amortized, O(Chunk) when the last chunk is shared.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Chunk number of entries per chunk.
+ *  @param val entry to append, will be copied.
+ */
+template <class T, size_t Chunk>
+void ChunkedStorage<T, Chunk>::push_back(const T &val)
+{
+  if(count % Chunk == 0)
+  {
+    chunks.push_back(std::make_shared<Block>());
+    chunks.back()->reserve(Chunk);
+  }
+  own(count / Chunk).push_back(val);
+  ++count;
+}
+
+/**
+ *  @brief Remove the last entry.
+ *
+ *  A chunk left empty is released.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Chunk number of entries per chunk.
+ */
+template <class T, size_t Chunk>
+void ChunkedStorage<T, Chunk>::pop_back()
+{
+  --count;
+  if(count % Chunk == 0)
+  {
+    chunks.pop_back();
+  }
+  else
+  {
+    own(count / Chunk).pop_back();
+  }
+}
+
+/**
+ *  @brief Returns the number of chunks shared with another copy.
+ *
+ *  Useful to measure how much memory forked copies still have in common.
+ *
+ *  Complexity:\n
+ *    O(n/Chunk).
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Chunk number of entries per chunk.
+ */
+template <class T, size_t Chunk>
+size_t ChunkedStorage<T, Chunk>::sharedChunks() const noexcept
+{
+  size_t shared = 0;
+  for(size_t c = 0; c < chunks.size(); ++c)
+  {
+    shared += chunks[c].use_count() != 01;
+  }
+  return shared;
+}
+
+/**
+ *  @brief Make this ChunkedStorage the only owner of a chunk.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Chunk number of entries per chunk.
+ *  @param c index of the chunk.
+ *  @return the chunk, safe to modify.
+ */
+template <class T, size_t Chunk>
+typename ChunkedStorage<T, Chunk>::Block &ChunkedStorage<T, Chunk>::own(
+  size_t c)
+{
+  if(chunks[c].use_count() != 01)
+  {
+    std::shared_ptr<Block> copy = std::make_shared<Block>();
+    copy->reserve(Chunk);
+    copy->insert(copy->end(), chunks[c]->begin(), chunks[c]->end());
+    chunks[c] = copy;
+  }
+  return *chunks[c];
+}
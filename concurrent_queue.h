@@ -0,0 +1,74 @@
+#ifndef CONCURRENT_QUEUE_H
+#define CONCURRENT_QUEUE_H
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include "priority_queue.h"
+
+/**
+ *  ConcurrentPriorityQueue class defines a thread safe min-heap whose minimum
+ *  can be read without taking its lock.
+ *
+ *  <p>
+ *  Mutations are serialized by a mutex around a PriorityQueue. Whenever a
+ *  mutation changes the minimum, the new minimum is published to a snapshot
+ *  guarded by a sequence lock. peekMin() copies the snapshot and retries only
+ *  if a publish overlapped the copy, so threads polling for ready work never
+ *  touch the mutex and never delay the writers.
+ *  </p>
+ *
+ *  <p>
+ *  The snapshot is copied word by word while it may be concurrently
+ *  rewritten, so T must be trivially copyable. Queue entries that are not
+ *  should be split into a trivially copyable key and a separately stored
+ *  payload.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the ConcurrentPriorityQueue().
+ *    Tuning arity and prefetch distance of the heap.
+ *
+ *  Member Variables:\n
+ *    lock mutex serializing mutations of queue.
+ *    queue PriorityQueue holding the entries.
+ *    sequence seqlock counter, odd while a publish is in progress.
+ *    count number of entries, published with the snapshot.
+ *    snapshot words of the published minimum.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor.
+ *    - size() return the number of entries without locking.
+ *    - peekMin() copy the published minimum without locking.
+ *    - insert() insert a new entry.
+ *    - tryRemoveMin() remove the minimum entry if there is one.
+ *    - publish() private helper publish the minimum, called under lock.
+ *  </p>
+ */
+template <class T, class Tuning = PriorityQueueTuning<sizeof(T)> >
+class ConcurrentPriorityQueue
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+    "the published minimum is copied while it may be rewritten");
+
+  public:
+    ConcurrentPriorityQueue();
+    size_t size() const noexcept;
+    bool peekMin(T &) const noexcept;
+    void insert(T);
+    bool tryRemoveMin(T &);
+
+  private:
+    typedef unsigned long long Word;
+    static const size_t words = (sizeof(T) + sizeof(Word) - 01) / sizeof(Word);
+    void publish() noexcept;
+    std::mutex lock;
+    PriorityQueue<T, Identity<T>, Tuning> queue;
+    char pad[0x40];
+    std::atomic<unsigned> sequence;
+    std::atomic<size_t> count;
+    std::atomic<Word> snapshot[words];
+};
+
+#include "concurrent_queue.hxx"
+#endif
@@ -0,0 +1,173 @@
+#include <cstring>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  The seqlock follows the C++11 memory model formulation: the snapshot is an
+ *  array of relaxed atomic words rather than a plain T, so a reader racing a
+ *  publish reads stale or mixed words instead of invoking undefined
+ *  behaviour, and the sequence check discards the copy. The writer bumps the
+ *  sequence to odd, issues a release fence, stores the words and releases
+ *  the even sequence. The reader acquires the sequence, copies, issues an
+ *  acquire fence and rereads the sequence.
+ *  </p>
+ *
+ *  <p>
+ *  count is part of the published state so peekMin() can tell an empty queue
+ *  apart from a stale minimum.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty ConcurrentPriorityQueue.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Tuning>
+ConcurrentPriorityQueue<T, Tuning>::ConcurrentPriorityQueue() :
+  sequence(0), count(0)
+{
+  for(size_t w = 0; w < words; ++w)
+  {
+    snapshot[w].store(0, std::memory_order_relaxed);
+  }
+}
+
+/**
+ *  @brief Returns the number of entries.
+ *
+ *  Read without locking, so it may already be stale when returned.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Tuning>
+size_t ConcurrentPriorityQueue<T, Tuning>::size() const noexcept
+{
+  return count.load(std::memory_order_relaxed);
+}
+
+/**
+ *  @brief Copies the most recently published minimum entry.
+ *
+ *  Never takes the lock. The copy is retried only while a publish is in
+ *  progress, which lasts for a handful of stores.
+ *
+ *  Complexity:\n
+ *    O(sizeof(T)) per attempt.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param out set to the minimum entry when the queue is non-empty.
+ *  @return false if the queue was empty.
+ */
+template <class T, class Tuning>
+bool ConcurrentPriorityQueue<T, Tuning>::peekMin(T &out) const noexcept
+{
+  Word buf[words];
+  size_t n;
+  unsigned before;
+  do
+  {
+    while((before = sequence.load(std::memory_order_acquire)) & 01)
+    {
+    }
+    n = count.load(std::memory_order_relaxed);
+    for(size_t w = 0; w < words; ++w)
+    {
+      buf[w] = snapshot[w].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while(sequence.load(std::memory_order_relaxed) != before);
+
+  if(n == 0)
+  {
+    return false;
+  }
+  std::memcpy(&out, buf, sizeof(T));
+  return true;
+}
+
+/**
+ *  @brief Inserts a new entry.
+ *
+ *  The snapshot is only republished when the entry becomes the new minimum,
+ *  otherwise only the count changes.
+ *
+ *  Complexity:\n
+ *    O(log(n)) amortized, where n is size().
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param val new object to be stored, will be copied.
+ */
+template <class T, class Tuning>
+void ConcurrentPriorityQueue<T, Tuning>::insert(T val)
+{
+  std::lock_guard<std::mutex> guard(lock);
+  bool newMin = queue.size() == 0 || val < queue.min();
+  queue.insert(val);
+  if(newMin)
+  {
+    publish();
+  }
+  else
+  {
+    count.store(queue.size(), std::memory_order_relaxed);
+  }
+}
+
+/**
+ *  @brief Removes the minimum entry and publishes the next one.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size().
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param out set to the removed entry.
+ *  @return false if the queue was empty.
+ */
+template <class T, class Tuning>
+bool ConcurrentPriorityQueue<T, Tuning>::tryRemoveMin(T &out)
+{
+  std::lock_guard<std::mutex> guard(lock);
+  if(queue.size() == 0)
+  {
+    return false;
+  }
+  out = queue.removeMin();
+  publish();
+  return true;
+}
+
+/**
+ *  @brief Publish the current minimum and count. Must hold lock.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Tuning>
+void ConcurrentPriorityQueue<T, Tuning>::publish() noexcept
+{
+  Word buf[words] = {};
+  if(queue.size() != 0)
+  {
+    T min = queue.min();
+    std::memcpy(buf, &min, sizeof(T));
+  }
+
+  unsigned s = sequence.load(std::memory_order_relaxed);
+  sequence.store(s + 01, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  count.store(queue.size(), std::memory_order_relaxed);
+  for(size_t w = 0; w < words; ++w)
+  {
+    snapshot[w].store(buf[w], std::memory_order_relaxed);
+  }
+  sequence.store(s + 02, std::memory_order_release);
+}
@@ -0,0 +1,88 @@
+#ifndef DELAY_QUEUE_H
+#define DELAY_QUEUE_H
+#include <chrono>
+#include <mutex>
+#include "futex.h"
+#include "priority_queue.h"
+
+/**
+ *  DelayQueue class defines a thread safe queue whose entries only become
+ *  available once their deadline has passed.
+ *
+ *  <p>
+ *  Entries are kept in a PriorityQueue ordered by deadline, ties broken by
+ *  insertion order. A consumer sleeps exactly until the deadline of the
+ *  root. Inserting an entry that becomes the new root wakes one sleeping
+ *  consumer so it can shorten its sleep, and a consumer that takes an entry
+ *  while others remain wakes the next one. No thread polls.
+ *  </p>
+ *
+ *  <p>
+ *  Time is read from Clock, any type with the interface of the std::chrono
+ *  clocks. Tests substitute a manually advanced clock. Sleeping is always
+ *  done on the steady clock, so when Clock can jump, e.g. a manual clock or
+ *  a simulation clock, call clockChanged() after moving it to make sleepers
+ *  reevaluate their deadlines.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the DelayQueue().
+ *    Clock clock deadlines are measured on, defaults to steady_clock.
+ *
+ *  Member Variables:\n
+ *    lock mutex guarding queue, sequence and waiters.
+ *    queue PriorityQueue of Entry ordered by deadline.
+ *    sequence insertion counter used to break deadline ties.
+ *    waiters number of consumers registered to sleep.
+ *    leader the consumer sleeping until the root's deadline, if any.
+ *    ready Futex bumped to wake consumers.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor.
+ *    - size() return the number of entries, expired or not.
+ *    - push() insert an entry available at a deadline.
+ *    - take() remove the earliest expired entry, blocking until there is one.
+ *    - tryTake() remove the earliest expired entry if there is one.
+ *    - clockChanged() wake every consumer to reread Clock.
+ *    - wakeOne() private helper wake one consumer if any is waiting.
+ *  </p>
+ */
+template <class T, class Clock = std::chrono::steady_clock>
+class DelayQueue
+{
+  public:
+    typedef typename Clock::time_point time_point;
+    DelayQueue();
+    size_t size();
+    void push(T, time_point);
+    T take();
+    bool tryTake(T &);
+    void clockChanged();
+
+  private:
+    /**
+     *  Entry is a queued value with its deadline, ordered by deadline and
+     *  then insertion order.
+     */
+    struct Entry
+    {
+      time_point at;
+      unsigned long long sequence;
+      T val;
+      bool operator<(const Entry &o) const
+      {
+        return at < o.at || (!(o.at < at) && sequence < o.sequence);
+      }
+    };
+    void wakeOne(bool);
+    std::mutex lock;
+    PriorityQueue<Entry> queue;
+    unsigned long long sequence;
+    size_t waiters;
+    const void *leader;
+    Futex ready;
+};
+
+#include "delay_queue.hxx"
+#endif
@@ -0,0 +1,189 @@
+#include <climits>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  Waiting follows BlockingPriorityQueue: the Futex value is read under the
+ *  lock and slept on after releasing it, so a wake issued in between is not
+ *  lost. The sleep deadline is the root's deadline translated to the steady
+ *  clock at the moment the consumer goes to sleep.
+ *  </p>
+ *
+ *  <p>
+ *  Only one consumer, the leader, sleeps until the root's deadline. The
+ *  others sleep untimed, so an expiry wakes one thread instead of all of
+ *  them. The leader is identified by the address of a local of its take()
+ *  frame. An earlier push() deposes the leader and wakes one consumer, which
+ *  becomes the new leader with the shorter deadline. A consumer leaving
+ *  take() with entries still queued wakes one more to take over.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty DelayQueue.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Clock clock deadlines are measured on.
+ */
+template <class T, class Clock>
+DelayQueue<T, Clock>::DelayQueue() : sequence(0), waiters(0), leader(NULL)
+{
+}
+
+/**
+ *  @brief Returns the number of entries, including those not yet expired.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Clock clock deadlines are measured on.
+ */
+template <class T, class Clock>
+size_t DelayQueue<T, Clock>::size()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  return queue.size();
+}
+
+/**
+ *  @brief Inserts an entry that becomes available at a deadline.
+ *
+ *  A sleeping consumer is woken only if the entry is the new earliest one,
+ *  any later entry cannot shorten anyone's sleep.
+ *
+ *  Complexity:\n
+ *    O(log(n)) amortized, where n is size().
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Clock clock deadlines are measured on.
+ *  @param val new object to be stored, will be copied.
+ *  @param at deadline at which val can be taken.
+ */
+template <class T, class Clock>
+void DelayQueue<T, Clock>::push(T val, time_point at)
+{
+  bool wake;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    Entry e = {at, sequence++, val};
+    wake = queue.size() == 0 || e < queue.min();
+    queue.insert(e);
+    if(wake)
+    {
+      leader = NULL; //the leader's deadline is no longer the earliest
+    }
+    wake = wake && waiters != 0;
+  }
+  wakeOne(wake);
+}
+
+/**
+ *  @brief Removes the entry with the earliest deadline, blocking until that
+ *  deadline has passed.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size(), once an entry has expired.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Clock clock deadlines are measured on.
+ *  @return T the removed entry.
+ */
+template <class T, class Clock>
+T DelayQueue<T, Clock>::take()
+{
+  std::unique_lock<std::mutex> guard(lock);
+  char self;
+  for(;;)
+  {
+    time_point now = Clock::now();
+    if(queue.size() != 0 && !(now < queue.min().at))
+    {
+      break;
+    }
+    //only subtract once the deadline is known to be ahead, it may be min()
+    typename Clock::duration left = queue.size() != 0 ?
+      queue.min().at - now : Clock::duration::zero();
+
+    unsigned seen = ready.load();
+    bool timed = queue.size() != 0 && leader == NULL;
+    std::chrono::steady_clock::time_point until =
+      std::chrono::steady_clock::now() +
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(left);
+    if(timed)
+    {
+      leader = &self;
+    }
+    ++waiters;
+    guard.unlock();
+    if(timed)
+    {
+      ready.waitUntil(seen, until);
+    }
+    else
+    {
+      ready.wait(seen);
+    }
+    guard.lock();
+    --waiters;
+    if(leader == &self)
+    {
+      leader = NULL;
+    }
+  }
+
+  T val = queue.removeMin().val;
+  bool wake = queue.size() != 0 && waiters != 0;
+  guard.unlock();
+  wakeOne(wake);
+  return val;
+}
+
+/**
+ *  @brief Removes the entry with the earliest deadline if it has passed.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Clock clock deadlines are measured on.
+ *  @param out set to the removed entry.
+ *  @return false if no entry has expired.
+ */
+template <class T, class Clock>
+bool DelayQueue<T, Clock>::tryTake(T &out)
+{
+  std::lock_guard<std::mutex> guard(lock);
+  if(queue.size() == 0 || Clock::now() < queue.min().at)
+  {
+    return false;
+  }
+  out = queue.removeMin().val;
+  return true;
+}
+
+/**
+ *  @brief Wake every sleeping consumer so it rereads Clock.
+ *
+ *  Only needed for clocks that can jump relative to the steady clock.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Clock clock deadlines are measured on.
+ */
+template <class T, class Clock>
+void DelayQueue<T, Clock>::clockChanged()
+{
+  ready.bump();
+  ready.wake(INT_MAX);
+}
+
+/**
+ *  @brief Wake one sleeping consumer.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Clock clock deadlines are measured on.
+ *  @param wake whether a consumer was seen waiting, nothing is done if not.
+ */
+template <class T, class Clock>
+void DelayQueue<T, Clock>::wakeOne(bool wake)
+{
+  if(wake)
+  {
+    ready.bump();
+    ready.wake(01);
+  }
+}
@@ -0,0 +1,103 @@
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "futex.h"
+
+/**
+ *  Graph is a directed graph with non-negative edge weights in compressed
+ *  sparse row form: the edges leaving vertex v are targets and weights at
+ *  indices offsets[v] up to offsets[v + 1].
+ *
+ *  Member Variables:\n
+ *    offsets first edge of each vertex, one more entry than vertices.
+ *    targets head of each edge.
+ *    weights weight of each edge, at least 0.
+ */
+struct Graph
+{
+  std::vector<size_t> offsets;
+  std::vector<unsigned> targets;
+  std::vector<float> weights;
+  size_t vertices() const noexcept
+  {
+    return offsets.empty() ? 0 : offsets.size() - 01;
+  }
+};
+
+inline void dijkstra(const Graph &, unsigned, std::vector<double> &);
+
+/**
+ *  DeltaStepping class computes single source shortest paths with the
+ *  parallel delta-stepping algorithm of Meyer and Sanders.
+ *
+ *  <p>
+ *  Tentative distances are grouped into buckets of width delta, which are
+ *  settled in increasing order. Within a bucket every vertex is processed in
+ *  parallel, relaxing its light edges, those of weight at most delta, which
+ *  may put vertices back into the same bucket. Once the bucket stays empty
+ *  the heavy edges of every vertex it settled are relaxed once. A delta
+ *  below the smallest weight settles buckets one distance at a time, like
+ *  Dijkstra's algorithm, a huge one degrades to Bellman-Ford. A delta near
+ *  the maximum weight divided by the average degree is a good start.
+ *  </p>
+ *
+ *  <p>
+ *  Relaxing a vertex of the current bucket reaches at most
+ *  1 + maxWeight / delta buckets ahead, so the buckets live in a cyclic
+ *  array of floor(maxWeight / delta) + 2 slots, bucket b in slot b % slots,
+ *  reused as the run advances. Memory is independent of the longest
+ *  distance, but grows with maxWeight / delta, so a delta that would need
+ *  more than maxSlots slots is rejected.
+ *  </p>
+ *
+ *  <p>
+ *  Buckets are concurrent without locks: every thread appends the vertices
+ *  it relaxes to its own buffer per bucket, and the buffers of the current
+ *  bucket are concatenated into a shared frontier between phases. Threads
+ *  claim chunks of the frontier with an atomic cursor and lower distances
+ *  with compare and swap. A vertex may be queued more than once, copies whose
+ *  distance has since moved to an earlier bucket are skipped.
+ *  </p>
+ *
+ *  <p>
+ *  The constructor reorders each vertex's edges light first, so relaxing
+ *  light or heavy edges scans a contiguous range.
+ *  </p>
+ *
+ *  Member Variables:\n
+ *    delta bucket width.
+ *    slots number of buckets in each thread's cyclic array.
+ *    threads number of threads a run uses, including the calling one.
+ *    offsets, targets, weights the graph, each vertex's light edges first.
+ *    lightEnd end of the light edges of each vertex.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) split the edges of a graph into light and heavy,
+ *        throws std::invalid_argument if delta is not positive or too small
+ *        for the weights.
+ *    - run() compute the distances from a source vertex.
+ *  </p>
+ */
+class DeltaStepping
+{
+  public:
+    DeltaStepping(const Graph &, double, size_t);
+    void run(unsigned, std::vector<double> &) const;
+
+  private:
+    struct Run;
+    static const size_t maxSlots = size_t(01) << 20;
+    double delta;
+    size_t slots;
+    size_t threads;
+    std::vector<size_t> offsets;
+    std::vector<size_t> lightEnd;
+    std::vector<unsigned> targets;
+    std::vector<float> weights;
+};
+
+#include "delta_stepping.hxx"
+#endif
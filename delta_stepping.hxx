@@ -0,0 +1,372 @@
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "priority_queue.h"
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  A run alternates three steps, separated by barriers. First every thread
+ *  publishes how many vertices it buffered for the current bucket, and the
+ *  last thread to arrive sizes the frontier and assigns each thread its
+ *  range. Then every thread moves its buffer into its range. Then the
+ *  frontier is processed, threads claiming chunks of it, which fills the
+ *  buffers again. When the first step finds nothing buffered the bucket is
+ *  settled: threads relax the heavy edges of the vertices they settled, and
+ *  the last thread to arrive picks the lowest bucket any thread buffered as
+ *  the next one, scanning the slots after the current one.
+ *  </p>
+ *
+ *  <p>
+ *  A vertex of bucket b at distance below (b + 1) * delta relaxed over an
+ *  edge of weight at most maxWeight lands below bucket
+ *  b + 1 + maxWeight / delta, so buffered vertices span at most
+ *  floor(maxWeight / delta) + 2 buckets from the current one and never share
+ *  a slot with another bucket. When delta divides maxWeight the last slot is
+ *  spare, absorbing rounding of the division. Slots are cleared rather than
+ *  freed once moved to the frontier, so their capacity is reused by later
+ *  buckets.
+ *  </p>
+ *
+ *  <p>
+ *  Distances are atomics updated with relaxed compare and swap. The
+ *  barriers order all of a phase's updates before the next phase, and
+ *  within a phase a stale read only costs a redundant relaxation.
+ *  </p>
+ */
+
+/**
+ *  Run is the state of one call of run(), shared by its threads.
+ *
+ *  Member Variables:\n
+ *    owner the DeltaStepping being run.
+ *    dist tentative distance of each vertex.
+ *    settled per vertex one more than the last bucket it was settled in.
+ *    locals per thread buffers.
+ *    frontier vertices of the current bucket being processed.
+ *    claim next unclaimed index of frontier.
+ *    bucket the current bucket.
+ *    finished set when no thread has buffered vertices.
+ *    arrived, generation barrier state.
+ */
+struct DeltaStepping::Run
+{
+  /**
+   *  Local is one thread's buffer of vertices per bucket slot and its list of
+   *  vertices settled in the current bucket, padded against false sharing.
+   */
+  struct Local
+  {
+    char front[0x40];
+    std::vector<std::vector<unsigned> > bins;
+    std::vector<unsigned> settled;
+    size_t count;
+    size_t offset;
+    char back[0x40];
+  };
+
+  Run(const DeltaStepping &, size_t);
+  void work(size_t);
+  template <class Last>
+  void barrier(Last);
+  void relax(Local &, unsigned, double);
+  size_t bucketOf(double d) const { return size_t(d / owner.delta); }
+  std::vector<unsigned> &bin(Local &l, size_t b) const
+  {
+    return l.bins[b % owner.slots];
+  }
+
+  const DeltaStepping &owner;
+  std::unique_ptr<std::atomic<double>[]> dist;
+  std::unique_ptr<std::atomic<size_t>[]> settled;
+  std::vector<Local> locals;
+  std::vector<unsigned> frontier;
+  std::atomic<size_t> claim;
+  size_t bucket;
+  bool finished;
+  std::atomic<size_t> arrived;
+  Futex generation;
+};
+
+/**
+ *  @brief Computes shortest path distances with Dijkstra's algorithm on a
+ *  PriorityQueue, the sequential reference for DeltaStepping.
+ *
+ *  Complexity:\n
+ *    O(m log(m)) where m is the number of edges.
+ *
+ *  @param g the graph.
+ *  @param source vertex distances are measured from.
+ *  @param dist set to the distance of each vertex, infinity if unreachable.
+ */
+inline void dijkstra(const Graph &g, unsigned source, std::vector<double> &dist)
+{
+  dist.assign(g.vertices(), std::numeric_limits<double>::infinity());
+  PriorityQueue<std::pair<double, unsigned> > q;
+  dist[source] = 0;
+  q.insert(std::make_pair(0.0, source));
+  while(q.size() != 0)
+  {
+    std::pair<double, unsigned> e = q.removeMin();
+    if(e.first != dist[e.second])
+    {
+      continue;
+    }
+    for(size_t i = g.offsets[e.second]; i < g.offsets[e.second + 01]; ++i)
+    {
+      double d = e.first + g.weights[i];
+      if(d < dist[g.targets[i]])
+      {
+        dist[g.targets[i]] = d;
+        q.insert(std::make_pair(d, g.targets[i]));
+      }
+    }
+  }
+}
+
+/**
+ *  @brief Prepares a graph for delta-stepping, reordering each vertex's
+ *  edges light first.
+ *
+ *  @param g the graph, copied.
+ *  @param delta bucket width, greater than 0.
+ *  @param threads number of threads a run uses, at least 1.
+ *  @throws std::invalid_argument if delta is not greater than 0 or the
+ *    maximum weight divided by delta needs more than maxSlots buckets.
+ */
+inline DeltaStepping::DeltaStepping(const Graph &g, double delta,
+  size_t threads) :
+  delta(delta), slots(0), threads(threads ? threads : 01),
+  offsets(g.offsets), lightEnd(g.vertices()), targets(g.targets.size()),
+  weights(g.weights.size())
+{
+  if(!(delta > 0))
+  {
+    throw std::invalid_argument("delta must be greater than 0");
+  }
+  double maxWeight = 0;
+  for(size_t i = 0; i < g.weights.size(); ++i)
+  {
+    maxWeight = std::max(maxWeight, double(g.weights[i]));
+  }
+  if(maxWeight / delta >= maxSlots - 02)
+  {
+    throw std::invalid_argument("delta too small for the edge weights");
+  }
+  slots = size_t(maxWeight / delta) + 02;
+
+  for(size_t v = 0; v < g.vertices(); ++v)
+  {
+    size_t light = offsets[v];
+    size_t heavy = offsets[v + 01];
+    for(size_t i = g.offsets[v]; i < g.offsets[v + 01]; ++i)
+    {
+      size_t to = g.weights[i] <= delta ? light++ : --heavy;
+      targets[to] = g.targets[i];
+      weights[to] = g.weights[i];
+    }
+    lightEnd[v] = light;
+  }
+}
+
+/**
+ *  @brief Computes the distance of every vertex from a source.
+ *
+ *  Complexity:\n
+ *    O(n + m + L/delta) work for n vertices, m edges and maximum distance
+ *    L, with O(L/delta) phases of parallel steps on random weights.
+ *
+ *  @param source vertex distances are measured from.
+ *  @param dist set to the distance of each vertex, infinity if unreachable.
+ */
+inline void DeltaStepping::run(unsigned source, std::vector<double> &dist) const
+{
+  size_t n = lightEnd.size();
+  Run r(*this, n);
+  r.dist[source].store(0, std::memory_order_relaxed);
+  r.locals[0].bins[0].push_back(source);
+
+  std::vector<std::thread> pool;
+  for(size_t t = 01; t < threads; ++t)
+  {
+    pool.push_back(std::thread(&Run::work, &r, t));
+  }
+  r.work(0);
+  for(size_t t = 0; t < pool.size(); ++t)
+  {
+    pool[t].join();
+  }
+
+  dist.resize(n);
+  for(size_t v = 0; v < n; ++v)
+  {
+    dist[v] = r.dist[v].load(std::memory_order_relaxed);
+  }
+}
+
+/**
+ *  @brief Sets every distance to infinity and allocates the bucket slots.
+ *
+ *  @param owner the DeltaStepping being run.
+ *  @param n number of vertices.
+ */
+inline DeltaStepping::Run::Run(const DeltaStepping &owner, size_t n) :
+  owner(owner), dist(new std::atomic<double>[n]),
+  settled(new std::atomic<size_t>[n]), locals(owner.threads), claim(0),
+  bucket(0), finished(false), arrived(0)
+{
+  for(size_t v = 0; v < n; ++v)
+  {
+    dist[v].store(std::numeric_limits<double>::infinity(),
+      std::memory_order_relaxed);
+    settled[v].store(0, std::memory_order_relaxed);
+  }
+  for(size_t t = 0; t < locals.size(); ++t)
+  {
+    locals[t].bins.resize(owner.slots);
+  }
+}
+
+/**
+ *  @brief Wait until every thread arrives, the last one to arrive runs a
+ *  function before releasing the others.
+ *
+ *  @param last called by the last thread to arrive.
+ */
+template <class Last>
+inline void DeltaStepping::Run::barrier(Last last)
+{
+  unsigned seen = generation.load();
+  if(arrived.fetch_add(01, std::memory_order_acq_rel) + 01 == locals.size())
+  {
+    last();
+    arrived.store(0, std::memory_order_relaxed);
+    generation.bump();
+    generation.wake(INT_MAX);
+    return;
+  }
+  while(generation.load() == seen)
+  {
+    generation.wait(seen);
+  }
+}
+
+/**
+ *  @brief Lower the distance of a vertex, buffering it in the bucket of
+ *  its new distance if it was lowered.
+ *
+ *  @param local the calling thread's buffers.
+ *  @param v the vertex.
+ *  @param d candidate distance.
+ */
+inline void DeltaStepping::Run::relax(Local &local, unsigned v, double d)
+{
+  double old = dist[v].load(std::memory_order_relaxed);
+  while(d < old)
+  {
+    if(dist[v].compare_exchange_weak(old, d, std::memory_order_relaxed))
+    {
+      bin(local, bucketOf(d)).push_back(v);
+      return;
+    }
+  }
+}
+
+/**
+ *  @brief Body of every thread of a run.
+ *
+ *  @param t index of the thread's Local.
+ */
+inline void DeltaStepping::Run::work(size_t t)
+{
+  static const size_t chunk = 0x40;
+  Local &local = locals[t];
+  for(;;)
+  {
+    local.count = bin(local, bucket).size();
+    barrier([this]()
+    {
+      size_t total = 0;
+      for(size_t i = 0; i < locals.size(); ++i)
+      {
+        locals[i].offset = total;
+        total += locals[i].count;
+      }
+      frontier.resize(total);
+      claim.store(0, std::memory_order_relaxed);
+    });
+
+    if(frontier.empty())
+    {
+      for(size_t i = 0; i < local.settled.size(); ++i)
+      {
+        unsigned v = local.settled[i];
+        double d = dist[v].load(std::memory_order_relaxed);
+        for(size_t e = owner.lightEnd[v]; e < owner.offsets[v + 01]; ++e)
+        {
+          relax(local, owner.targets[e], d + owner.weights[e]);
+        }
+      }
+      local.settled.clear();
+      barrier([this]()
+      {
+        size_t next = SIZE_MAX;
+        for(size_t i = 0; i < locals.size(); ++i)
+        {
+          for(size_t b = bucket; b < bucket + owner.slots && b < next; ++b)
+          {
+            if(!bin(locals[i], b).empty())
+            {
+              next = b;
+            }
+          }
+        }
+        finished = next == SIZE_MAX;
+        bucket = next;
+      });
+      if(finished)
+      {
+        return;
+      }
+      continue;
+    }
+
+    if(local.count != 0)
+    {
+      std::vector<unsigned> &current = bin(local, bucket);
+      std::copy(current.begin(), current.end(),
+        frontier.begin() + local.offset);
+      current.clear();
+    }
+    barrier([]() {});
+
+    size_t begin;
+    while((begin = claim.fetch_add(chunk, std::memory_order_relaxed)) <
+      frontier.size())
+    {
+      size_t end = std::min(begin + chunk, frontier.size());
+      for(size_t i = begin; i < end; ++i)
+      {
+        unsigned v = frontier[i];
+        double d = dist[v].load(std::memory_order_relaxed);
+        if(bucketOf(d) != bucket)
+        {
+          continue;
+        }
+        if(settled[v].exchange(bucket + 01, std::memory_order_relaxed) !=
+          bucket + 01)
+        {
+          local.settled.push_back(v);
+        }
+        for(size_t e = owner.offsets[v]; e < owner.lightEnd[v]; ++e)
+        {
+          relax(local, owner.targets[e], d + owner.weights[e]);
+        }
+      }
+    }
+  }
+}
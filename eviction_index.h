@@ -0,0 +1,98 @@
+#ifndef EVICTION_INDEX_H
+#define EVICTION_INDEX_H
+#include <vector>
+#include "indexed_heap.h"
+
+/**
+ *  EvictionIndex class picks eviction victims of a cache by least frequency
+ *  or cost and expires entries by deadline, keyed by the dense slot ids of
+ *  the cache's own storage.
+ *
+ *  <p>
+ *  Every cached slot has a priority, typically its hit count or the cost of
+ *  recomputing it, and optionally an expiry time. touch() is on the hit path
+ *  and only adds to a pending bump of the slot, without reordering anything.
+ *  evict() applies pending bumps lazily: while the slot at the root of the
+ *  priority heap has a pending bump, the bump is folded into its priority
+ *  and it is sifted down. Bumps only raise priorities, so stored priorities
+ *  are lower bounds and a root without a pending bump is the true minimum.
+ *  Each bump is therefore applied at most once, by the evict() that reaches
+ *  it, however many touches it absorbed.
+ *  </p>
+ *
+ *  <p>
+ *  Expiry times are in caller chosen ticks, e.g. seconds since start, with
+ *  never meaning no expiry. Slots that expire are kept in a second indexed
+ *  heap, drained by expire().
+ *  </p>
+ *
+ *  <p>
+ *  Everything is stored in flat arrays indexed by slot, 28 bytes per slot
+ *  in all, see memoryUsage(), so 100M slots cost about 2.8GB. Nothing is
+ *  allocated per touch, and the memory does not depend on how often slots
+ *  are touched or reprioritized.
+ *  </p>
+ *
+ *  Member Variables:\n
+ *    priority stored priority of each slot.
+ *    pending bump not yet folded into priority.
+ *    expiry expiry time of each slot, never if none.
+ *    byPriority IndexedHeap of cached slots by stored priority.
+ *    byExpiry IndexedHeap of slots with an expiry, by expiry time.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) preallocate room for a number of slots.
+ *    - size() return the number of slots cached.
+ *    - contains() return whether a slot is cached.
+ *    - priorityOf() return the priority of a slot including pending bumps.
+ *    - insert() add a slot with a priority and an optional expiry.
+ *    - touch() bump the priority of a slot in constant time.
+ *    - reprioritize() set the priority of a slot, e.g. a new cost.
+ *    - erase() remove a slot.
+ *    - evict() remove and return the slot of least priority.
+ *    - expire() remove and return every slot expired at a time.
+ *    - memoryUsage() return the bytes allocated.
+ *    - grow() private helper make room for a slot.
+ *  </p>
+ */
+class EvictionIndex
+{
+  public:
+    enum { never = ~0u };
+    explicit EvictionIndex(size_t = 0);
+    EvictionIndex(const EvictionIndex &) = delete;
+    EvictionIndex &operator=(const EvictionIndex &) = delete;
+    size_t size() const noexcept;
+    bool contains(unsigned) const noexcept;
+    unsigned priorityOf(unsigned) const noexcept;
+    void insert(unsigned, unsigned, unsigned = never);
+    void touch(unsigned, unsigned = 01) noexcept;
+    void reprioritize(unsigned, unsigned);
+    void erase(unsigned);
+    bool evict(unsigned &);
+    size_t expire(unsigned, std::vector<unsigned> &);
+    size_t memoryUsage() const noexcept;
+
+  private:
+    /**
+     *  Field projects a slot to its entry in one of the per slot arrays.
+     */
+    struct Field
+    {
+      const std::vector<unsigned> *values;
+      unsigned operator()(unsigned slot) const noexcept
+      {
+        return (*values)[slot];
+      }
+    };
+    void grow(unsigned);
+    std::vector<unsigned> priority;
+    std::vector<unsigned> pending;
+    std::vector<unsigned> expiry;
+    IndexedHeap<Field> byPriority;
+    IndexedHeap<Field> byExpiry;
+};
+
+#include "eviction_index.hxx"
+#endif
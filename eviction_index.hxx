@@ -0,0 +1,203 @@
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  Priorities and bumps saturate at the largest unsigned instead of
+ *  wrapping, so a very hot slot never turns into the coldest one.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty EvictionIndex.
+ *
+ *  @param slots number of slots to preallocate, more are added on demand.
+ */
+inline EvictionIndex::EvictionIndex(size_t slots) :
+  byPriority(Field{&priority}), byExpiry(Field{&expiry})
+{
+  priority.resize(slots, 0);
+  pending.resize(slots, 0);
+  expiry.resize(slots, never);
+  byPriority.reserve(slots);
+  byExpiry.reserve(slots);
+}
+
+/**
+ *  @brief Returns the number of slots cached.
+ */
+inline size_t EvictionIndex::size() const noexcept
+{
+  return byPriority.size();
+}
+
+/**
+ *  @brief Returns whether a slot is cached.
+ *
+ *  @param slot the slot.
+ */
+inline bool EvictionIndex::contains(unsigned slot) const noexcept
+{
+  return byPriority.contains(slot);
+}
+
+/**
+ *  @brief Returns the priority of a cached slot including pending bumps.
+ *
+ *  @param slot the slot.
+ */
+inline unsigned EvictionIndex::priorityOf(unsigned slot) const noexcept
+{
+  unsigned p = priority[slot] + pending[slot];
+  return p < priority[slot] ? never : p;
+}
+
+/**
+ *  @brief Adds a slot to the index.
+ *
+ *  Complexity:\n
+ *    O(log(n)) amortized, where n is size().
+ *
+ *  Precondition:\n
+ *    !contains(slot)
+ *
+ *  @param slot the slot.
+ *  @param initial priority of the slot.
+ *  @param expires time the slot expires at, never if it does not.
+ */
+inline void EvictionIndex::insert(unsigned slot, unsigned initial,
+  unsigned expires)
+{
+  grow(slot);
+  priority[slot] = initial;
+  pending[slot] = 0;
+  expiry[slot] = expires;
+  byPriority.push(slot);
+  if(expires != never)
+  {
+    byExpiry.push(slot);
+  }
+}
+
+/**
+ *  @brief Raises the priority of a cached slot without reordering.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @param slot the slot.
+ *  @param bump amount to raise the priority by.
+ */
+inline void EvictionIndex::touch(unsigned slot, unsigned bump) noexcept
+{
+  unsigned p = pending[slot] + bump;
+  pending[slot] = p < bump ? never : p;
+}
+
+/**
+ *  @brief Sets the priority of a cached slot, discarding pending bumps.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size().
+ *
+ *  @param slot the slot.
+ *  @param p the new priority.
+ */
+inline void EvictionIndex::reprioritize(unsigned slot, unsigned p)
+{
+  priority[slot] = p;
+  pending[slot] = 0;
+  byPriority.update(slot);
+}
+
+/**
+ *  @brief Removes a cached slot, e.g. when the cache deletes it.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size().
+ *
+ *  @param slot the slot.
+ */
+inline void EvictionIndex::erase(unsigned slot)
+{
+  byPriority.erase(slot);
+  if(byExpiry.contains(slot))
+  {
+    byExpiry.erase(slot);
+  }
+}
+
+/**
+ *  @brief Removes the slot of least priority, counting pending bumps.
+ *
+ *  Complexity:\n
+ *    O(log(n)) per pending bump applied plus O(log(n)) for the removal,
+ *    where n is size(). Each bump is applied once, so this is O(log(n))
+ *    amortized over the touches.
+ *
+ *  @param slot set to the evicted slot.
+ *  @return false if the index was empty.
+ */
+inline bool EvictionIndex::evict(unsigned &slot)
+{
+  while(byPriority.size() != 0)
+  {
+    unsigned top = byPriority.top();
+    if(pending[top] == 0)
+    {
+      slot = top;
+      erase(top);
+      return true;
+    }
+    priority[top] = priorityOf(top);
+    pending[top] = 0;
+    byPriority.update(top);
+  }
+  return false;
+}
+
+/**
+ *  @brief Removes every slot expired at a given time.
+ *
+ *  Complexity:\n
+ *    O(k log(n)) where k is the number of slots removed and n is size().
+ *
+ *  @param now the current time, slots whose expiry is at most now expire.
+ *  @param out expired slots are appended to it, earliest first.
+ *  @return the number of slots removed.
+ */
+inline size_t EvictionIndex::expire(unsigned now, std::vector<unsigned> &out)
+{
+  size_t removed = 0;
+  while(byExpiry.size() != 0 && expiry[byExpiry.top()] <= now)
+  {
+    unsigned slot = byExpiry.pop();
+    byPriority.erase(slot);
+    out.push_back(slot);
+    ++removed;
+  }
+  return removed;
+}
+
+/**
+ *  @brief Returns the bytes allocated for every slot's state and both
+ *  heaps, 28 bytes per slot once both heaps are full.
+ */
+inline size_t EvictionIndex::memoryUsage() const noexcept
+{
+  return (priority.capacity() + pending.capacity() + expiry.capacity()) *
+    sizeof(unsigned) + byPriority.memoryUsage() + byExpiry.memoryUsage();
+}
+
+/**
+ *  @brief Make room in the per slot arrays for a slot.
+ *
+ *  @param slot the slot.
+ */
+inline void EvictionIndex::grow(unsigned slot)
+{
+  if(slot >= priority.size())
+  {
+    priority.resize(slot + 01, 0);
+    pending.resize(slot + 01, 0);
+    expiry.resize(slot + 01, never);
+  }
+}
@@ -0,0 +1,54 @@
+#ifndef FUTEX_H
+#define FUTEX_H
+#include <atomic>
+#include <chrono>
+
+/**
+ *  Futex class defines a 32-bit word that threads can sleep on until another
+ *  thread changes it, using the Linux futex system call directly.
+ *
+ *  <p>
+ *  The usual pattern is: read the word, recheck the condition being waited
+ *  for, then wait() with the value read. A waker changes the condition,
+ *  bump()s the word and wakes. Because the kernel compares the word before
+ *  sleeping, a bump between the read and the wait makes the wait return
+ *  immediately instead of losing the wakeup.
+ *  </p>
+ *
+ *  <p>
+ *  A private futex is cheaper but only works between threads of one
+ *  process. A shared futex may be placed in memory mapped by several
+ *  processes.
+ *  </p>
+ *
+ *  Member Variables:\n
+ *    value the word waited on.
+ *    shared whether the futex is used across processes.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor.
+ *    - load() return the current value.
+ *    - bump() increment the value and return the new one.
+ *    - wait() sleep while the value equals an expected value.
+ *    - waitUntil() wait() with a steady_clock deadline.
+ *    - wake() wake up to a given number of waiters.
+ *  </p>
+ */
+class Futex
+{
+  public:
+    explicit Futex(bool shared = false) noexcept;
+    unsigned load() const noexcept;
+    unsigned bump() noexcept;
+    void wait(unsigned) noexcept;
+    bool waitUntil(unsigned, std::chrono::steady_clock::time_point) noexcept;
+    void wake(int) noexcept;
+
+  private:
+    std::atomic<unsigned> value;
+    bool shared;
+};
+
+#include "futex.hxx"
+#endif
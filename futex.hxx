@@ -0,0 +1,106 @@
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  std::atomic<unsigned> is lock free and has the size of the unsigned it
+ *  wraps on every Linux target, so its address is handed to the kernel as
+ *  the futex word.
+ *  </p>
+ *
+ *  <p>
+ *  Deadlines use FUTEX_WAIT_BITSET, whose timeout is absolute on
+ *  CLOCK_MONOTONIC, the clock behind std::chrono::steady_clock. Retrying
+ *  after a signal therefore does not extend the wait.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs a Futex holding 0.
+ *
+ *  @param shared whether the futex will be used between processes.
+ */
+inline Futex::Futex(bool shared) noexcept : value(0), shared(shared)
+{
+  static_assert(sizeof(std::atomic<unsigned>) == sizeof(int),
+    "the kernel expects a 32-bit futex word");
+}
+
+/**
+ *  @brief Returns the current value.
+ */
+inline unsigned Futex::load() const noexcept
+{
+  return value.load(std::memory_order_acquire);
+}
+
+/**
+ *  @brief Increment the value so current waiters stop waiting.
+ *
+ *  Does not wake anyone, call wake() afterwards.
+ *
+ *  @return the new value.
+ */
+inline unsigned Futex::bump() noexcept
+{
+  return value.fetch_add(01, std::memory_order_acq_rel) + 01;
+}
+
+/**
+ *  @brief Sleep while the value equals expected.
+ *
+ *  May return spuriously, callers recheck their condition.
+ *
+ *  @param expected value read before rechecking the waited for condition.
+ */
+inline void Futex::wait(unsigned expected) noexcept
+{
+  syscall(SYS_futex, reinterpret_cast<unsigned *>(&value),
+    shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+/**
+ *  @brief Sleep while the value equals expected, at most until a deadline.
+ *
+ *  May return spuriously, callers recheck their condition.
+ *
+ *  @param expected value read before rechecking the waited for condition.
+ *  @param deadline steady_clock time to give up at.
+ *  @return false if the deadline passed.
+ */
+inline bool Futex::waitUntil(unsigned expected,
+  std::chrono::steady_clock::time_point deadline) noexcept
+{
+  std::chrono::nanoseconds ns = std::chrono::duration_cast<
+    std::chrono::nanoseconds>(deadline.time_since_epoch());
+  if(ns.count() < 0)
+  {
+    return false;
+  }
+  timespec at;
+  at.tv_sec = ns.count() / 1000000000;
+  at.tv_nsec = ns.count() % 1000000000;
+  int op = FUTEX_WAIT_BITSET | (shared ? 0 : FUTEX_PRIVATE_FLAG);
+  if(syscall(SYS_futex, reinterpret_cast<unsigned *>(&value), op, expected,
+    &at, NULL, FUTEX_BITSET_MATCH_ANY) == -1 && errno == ETIMEDOUT)
+  {
+    return false;
+  }
+  return std::chrono::steady_clock::now() < deadline;
+}
+
+/**
+ *  @brief Wake up to n threads sleeping in wait() or waitUntil().
+ *
+ *  @param n number of threads to wake, INT_MAX for all.
+ */
+inline void Futex::wake(int n) noexcept
+{
+  syscall(SYS_futex, reinterpret_cast<unsigned *>(&value),
+    shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, n, NULL, NULL, 0);
+}
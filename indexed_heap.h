@@ -0,0 +1,81 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+#include <vector>
+#include "priority_queue.h"
+
+/**
+ *  IndexedHeap class defines a min-heap of dense integer ids that can find,
+ *  reorder and remove any id in O(log(n)).
+ *
+ *  <p>
+ *  The heap holds ids only, ordered by a Key projecting each id to its
+ *  priority, which typically reads a field of a caller-owned array indexed
+ *  by the id. A second array maps each id to its position in the heap, so
+ *  the priority of a queued id may change in place as long as update() is
+ *  called afterwards. This replaces the pattern of pushing a fresh entry
+ *  into a PriorityQueue on every change and skipping the stale ones, whose
+ *  memory grows with the number of changes instead of the number of ids.
+ *  </p>
+ *
+ *  <p>
+ *  Ids are unsigned, so up to 2^32 - 1 ids cost 4 bytes of heap and 4 bytes
+ *  of position each. The heap is 1-based and has the arity of a
+ *  PriorityQueue of unsigned, position 0 marks an id that is not queued.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    Key projection of an id to its priority, compared with <.
+ *    Tuning arity of the heap, defaults to the tuning for unsigned.
+ *
+ *  Member Variables:\n
+ *    heap ids in heap order, with a filler at position 0.
+ *    position position of each id in heap, 0 if it is not queued.
+ *    key projection of ids compared by the heap.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor, optionally taking the projection.
+ *    - size() return the number of queued ids.
+ *    - contains() return whether an id is queued.
+ *    - top() return the id of least priority.
+ *    - push() queue an id.
+ *    - pop() remove and return the id of least priority.
+ *    - erase() remove a queued id.
+ *    - update() restore heap order after the priority of an id changed.
+ *    - clear() remove every id, keeping the allocation.
+ *    - reserve() preallocate room for a number of ids.
+ *    - memoryUsage() return the bytes allocated.
+ *    - up(), down() private helpers sift a position towards the root or the
+ *        leaves.
+ *    - place() private helper store an id at a position.
+ *  </p>
+ */
+template <class Key, class Tuning = PriorityQueueTuning<sizeof(unsigned)> >
+class IndexedHeap
+{
+  public:
+    explicit IndexedHeap(const Key & = Key());
+    size_t size() const noexcept;
+    bool contains(unsigned) const noexcept;
+    unsigned top() const noexcept;
+    void push(unsigned);
+    unsigned pop();
+    void erase(unsigned);
+    void update(unsigned);
+    void clear() noexcept;
+    void reserve(size_t);
+    size_t memoryUsage() const noexcept;
+
+  private:
+    static const size_t arity = Tuning::arity;
+    static_assert(Tuning::arity >= 02, "a heap needs at least two children");
+    void up(size_t);
+    void down(size_t);
+    inline void place(unsigned, size_t) noexcept;
+    std::vector<unsigned> heap;
+    std::vector<unsigned> position;
+    Key key;
+};
+
+#include "indexed_heap.hxx"
+#endif
@@ -0,0 +1,293 @@
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  The layout follows PriorityQueue: 1-based, children of position n at
+ *  d(n-1)+2 through dn+1. Sifting moves a hole rather than swapping, so each
+ *  level writes one id and one position.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty IndexedHeap.
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ *  @param key projection of ids compared by the heap.
+ */
+template <class Key, class Tuning>
+IndexedHeap<Key, Tuning>::IndexedHeap(const Key &key) : heap(01), key(key)
+{
+}
+
+/**
+ *  @brief Returns the number of queued ids.
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class Key, class Tuning>
+size_t IndexedHeap<Key, Tuning>::size() const noexcept
+{
+  return heap.size() - 01;
+}
+
+/**
+ *  @brief Returns whether an id is queued.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ *  @param id the id.
+ */
+template <class Key, class Tuning>
+bool IndexedHeap<Key, Tuning>::contains(unsigned id) const noexcept
+{
+  return id < position.size() && position[id] != 0;
+}
+
+/**
+ *  @brief Returns the id of least priority.
+ *
+ *  Precondition:\n
+ *    size() > 0
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class Key, class Tuning>
+unsigned IndexedHeap<Key, Tuning>::top() const noexcept
+{
+  return heap[01];
+}
+
+/**
+ *  @brief Queues an id with its current priority.
+ *
+ *  Complexity:\n
+ *    O(log(n)) amortized, where n is size().
+ *
+ *  Precondition:\n
+ *    !contains(id)
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ *  @param id the id.
+ */
+template <class Key, class Tuning>
+void IndexedHeap<Key, Tuning>::push(unsigned id)
+{
+  if(id >= position.size())
+  {
+    position.resize(id + 01, 0);
+  }
+  heap.push_back(id);
+  position[id] = heap.size() - 01;
+  up(heap.size() - 01);
+}
+
+/**
+ *  @brief Removes and returns the id of least priority.
+ *
+ *  Complexity:\n
+ *    O(d log(n)/log(d)) where n is size() and d is the arity.
+ *
+ *  Precondition:\n
+ *    size() > 0
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class Key, class Tuning>
+unsigned IndexedHeap<Key, Tuning>::pop()
+{
+  unsigned id = heap[01];
+  erase(id);
+  return id;
+}
+
+/**
+ *  @brief Removes a queued id.
+ *
+ *  The last id takes its place and is sifted whichever way its priority
+ *  requires.
+ *
+ *  Complexity:\n
+ *    O(d log(n)/log(d)) where n is size() and d is the arity.
+ *
+ *  Precondition:\n
+ *    contains(id)
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ *  @param id the id.
+ */
+template <class Key, class Tuning>
+void IndexedHeap<Key, Tuning>::erase(unsigned id)
+{
+  size_t pos = position[id];
+  unsigned last = heap.back();
+  heap.pop_back();
+  position[id] = 0;
+  if(pos < heap.size())
+  {
+    place(last, pos);
+    update(last);
+  }
+}
+
+/**
+ *  @brief Restores heap order after the priority of a queued id changed in
+ *  either direction.
+ *
+ *  Complexity:\n
+ *    O(d log(n)/log(d)) where n is size() and d is the arity.
+ *
+ *  Precondition:\n
+ *    contains(id)
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ *  @param id the id.
+ */
+template <class Key, class Tuning>
+void IndexedHeap<Key, Tuning>::update(unsigned id)
+{
+  size_t pos = position[id];
+  if(pos > 01 && key(id) < key(heap[(pos + arity - 02) / arity]))
+  {
+    up(pos);
+  }
+  else
+  {
+    down(pos);
+  }
+}
+
+/**
+ *  @brief Removes every id, keeping the allocation.
+ *
+ *  Complexity:\n
+ *    O(n) where n is size().
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class Key, class Tuning>
+void IndexedHeap<Key, Tuning>::clear() noexcept
+{
+  for(size_t i = 01; i < heap.size(); ++i)
+  {
+    position[heap[i]] = 0;
+  }
+  heap.resize(01);
+}
+
+/**
+ *  @brief Preallocate room for ids below n, so pushing them never
+ *  reallocates.
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ *  @param n one more than the largest id expected.
+ */
+template <class Key, class Tuning>
+void IndexedHeap<Key, Tuning>::reserve(size_t n)
+{
+  heap.reserve(n + 01);
+  if(position.size() < n)
+  {
+    position.resize(n, 0);
+  }
+}
+
+/**
+ *  @brief Returns the bytes allocated for the heap and the positions.
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ */
+template <class Key, class Tuning>
+size_t IndexedHeap<Key, Tuning>::memoryUsage() const noexcept
+{
+  return (heap.capacity() + position.capacity()) * sizeof(unsigned);
+}
+
+/**
+ *  @brief Sift the id at a position towards the root.
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ *  @param pos the position.
+ */
+template <class Key, class Tuning>
+void IndexedHeap<Key, Tuning>::up(size_t pos)
+{
+  unsigned id = heap[pos];
+  while(pos > 01)
+  {
+    size_t parent = (pos + arity - 02) / arity;
+    if(!(key(id) < key(heap[parent])))
+    {
+      break;
+    }
+    place(heap[parent], pos);
+    pos = parent;
+  }
+  place(id, pos);
+}
+
+/**
+ *  @brief Sift the id at a position towards the leaves, always descending
+ *  to the least child.
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ *  @param pos the position.
+ */
+template <class Key, class Tuning>
+void IndexedHeap<Key, Tuning>::down(size_t pos)
+{
+  unsigned id = heap[pos];
+  size_t n = size();
+  for(;;)
+  {
+    size_t first = arity * (pos - 01) + 02;
+    if(first > n)
+    {
+      break;
+    }
+    size_t last = first + arity - 01 <= n ? first + arity - 01 : n;
+    size_t least = first;
+    for(size_t c = first + 01; c <= last; ++c)
+    {
+      if(key(heap[c]) < key(heap[least]))
+      {
+        least = c;
+      }
+    }
+    if(!(key(heap[least]) < key(id)))
+    {
+      break;
+    }
+    place(heap[least], pos);
+    pos = least;
+  }
+  place(id, pos);
+}
+
+/**
+ *  @brief Store an id at a position and record the position.
+ *
+ *  @tparam Key projection of an id to its priority.
+ *  @tparam Tuning arity of the heap.
+ *  @param id the id.
+ *  @param pos the position.
+ */
+template <class Key, class Tuning>
+inline void IndexedHeap<Key, Tuning>::place(unsigned id, size_t pos) noexcept
+{
+  heap[pos] = id;
+  position[id] = pos;
+}
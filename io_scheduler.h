@@ -0,0 +1,157 @@
+#ifndef IO_SCHEDULER_H
+#define IO_SCHEDULER_H
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <sys/types.h>
+#include "priority_queue.h"
+
+/**
+ *  IoCompletion reports the outcome of one request submitted to an
+ *  IoScheduler.
+ *
+ *  Member Variables:\n
+ *    id the id returned by IoScheduler::submit().
+ *    result bytes read, short at end of file, or -errno on failure.
+ */
+struct IoCompletion
+{
+  unsigned long long id;
+  ssize_t result;
+};
+
+/**
+ *  IoScheduler class defines an elevator scheduler for positional reads. It
+ *  turns scattered pread() requests into mostly sequential, larger reads.
+ *
+ *  <p>
+ *  Pending requests are ordered by (file descriptor, offset) in two
+ *  PriorityQueues: the current sweep holds requests at or past the head
+ *  position in the sweep direction, the next sweep holds those behind it.
+ *  When the current sweep runs dry the two swap. In CSCAN mode every sweep
+ *  ascends and the head wraps back to the start. In SCAN mode the direction
+ *  reverses each sweep.
+ *  </p>
+ *
+ *  <p>
+ *  dispatch() pops the next request and keeps popping while the following
+ *  ones overlap or touch the range read so far, up to maxCoalesce bytes,
+ *  then issues a single pread() and copies each request's slice into its
+ *  buffer. Before that, the oldest pending request is checked against
+ *  maxLatency: once it has waited that long it is served on its own, out of
+ *  sweep order, so requests far behind the head are never starved.
+ *  </p>
+ *
+ *  <p>
+ *  The scheduler does no I/O of its own accord and starts no threads, the
+ *  owner calls dispatch() whenever it wants the next read issued.
+ *  </p>
+ *
+ *  Member Variables:\n
+ *    mode SCAN or CSCAN.
+ *    maxCoalesce upper bound in bytes of a coalesced read.
+ *    maxLatency age after which a request is served out of order.
+ *    sweeps the current and the next sweep.
+ *    current index of the current sweep in sweeps.
+ *    descending whether the current sweep runs towards lower positions.
+ *    head position the current sweep has reached.
+ *    requests slots of pending requests, reused through unused.
+ *    unused indices of free slots.
+ *    batch slots of the requests coalesced by the current dispatch().
+ *    arrivals pending requests in submission order, for the latency cap.
+ *    pending number of requests submitted and not yet completed.
+ *    nextId id handed to the next submitted request.
+ *    scratch buffer of coalesced reads.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor.
+ *    - size() return the number of pending requests.
+ *    - submit() queue a read and return its id.
+ *    - dispatch() issue the next, possibly coalesced, read.
+ *    - keyOf() private helper sort key of a position in a sweep direction.
+ *    - ahead() private helper whether a position is still ahead of head.
+ *    - popLive() private helper pop the next pending request of a sweep.
+ *    - expired() private helper return the oldest request past maxLatency.
+ *    - complete() private helper finish a request and free its slot.
+ *  </p>
+ */
+class IoScheduler
+{
+  public:
+    enum Mode { SCAN, CSCAN };
+    typedef std::chrono::steady_clock Clock;
+
+    explicit IoScheduler(Mode = CSCAN, size_t = 01 << 20,
+      Clock::duration = std::chrono::milliseconds(100));
+    size_t size() const noexcept;
+    unsigned long long submit(int, off_t, size_t, char *);
+    size_t dispatch(std::vector<IoCompletion> &);
+
+  private:
+    /**
+     *  Position on disk, approximated by file then offset.
+     */
+    struct Position
+    {
+      unsigned long long file;
+      unsigned long long offset;
+      bool operator<(const Position &o) const
+      {
+        return file < o.file || (file == o.file && offset < o.offset);
+      }
+    };
+
+    /**
+     *  Entry is a sweep's reference to a request slot, under a key already
+     *  flipped for descending sweeps. id detects slots served out of order
+     *  and reused since.
+     */
+    struct Entry
+    {
+      Position key;
+      unsigned long long id;
+      size_t slot;
+      bool operator<(const Entry &o) const
+      {
+        return key < o.key || (!(o.key < key) && id < o.id);
+      }
+    };
+
+    /**
+     *  Request is a pending read.
+     */
+    struct Request
+    {
+      unsigned long long id;
+      int fd;
+      off_t offset;
+      size_t length;
+      char *buffer;
+      Clock::time_point submitted;
+      bool live;
+    };
+
+    static Position keyOf(const Position &, bool) noexcept;
+    bool ahead(const Position &) const noexcept;
+    bool popLive(PriorityQueue<Entry> &, Entry &);
+    bool expired(size_t &);
+    void complete(size_t, ssize_t, std::vector<IoCompletion> &);
+    Mode mode;
+    size_t maxCoalesce;
+    Clock::duration maxLatency;
+    PriorityQueue<Entry> sweeps[02];
+    size_t current;
+    bool descending;
+    Position head;
+    std::vector<Request> requests;
+    std::vector<size_t> unused;
+    std::vector<size_t> batch;
+    std::deque<Entry> arrivals;
+    size_t pending;
+    unsigned long long nextId;
+    std::vector<char> scratch;
+};
+
+#include "io_scheduler.hxx"
+#endif
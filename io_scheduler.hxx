@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  A request served early because of the latency cap keeps its Entry in a
+ *  sweep and in arrivals. Such entries are skipped lazily when they reach
+ *  the front: an entry is live only while its slot is live and still holds
+ *  the id it was queued with.
+ *  </p>
+ *
+ *  <p>
+ *  Descending sweeps store each position bitwise complemented, which
+ *  reverses its order, so both sweep directions use the same min-heap. SCAN
+ *  queues requests behind the head under the opposite direction to the
+ *  current one, ready for when the sweeps swap and the direction flips.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an idle IoScheduler.
+ *
+ *  @param mode SCAN to reverse direction every sweep, CSCAN to always
+ *    ascend.
+ *  @param maxCoalesce upper bound in bytes of a coalesced read.
+ *  @param maxLatency age after which a request is served out of order.
+ */
+inline IoScheduler::IoScheduler(Mode mode, size_t maxCoalesce,
+  Clock::duration maxLatency) : mode(mode), maxCoalesce(maxCoalesce),
+  maxLatency(maxLatency), current(0), descending(false), pending(0),
+  nextId(0)
+{
+  head.file = 0;
+  head.offset = 0;
+}
+
+/**
+ *  @brief Returns the number of requests not yet completed.
+ *
+ *  Complexity:\n
+ *    Constant.
+ */
+inline size_t IoScheduler::size() const noexcept
+{
+  return pending;
+}
+
+/**
+ *  @brief Queue a positional read.
+ *
+ *  Complexity:\n
+ *    O(log(n)) amortized, where n is size().
+ *
+ *  @param fd file descriptor to read from.
+ *  @param offset file offset to read at.
+ *  @param length number of bytes to read.
+ *  @param buffer destination, at least length bytes, must stay valid until
+ *    the request completes.
+ *  @return id reported in the request's IoCompletion.
+ */
+inline unsigned long long IoScheduler::submit(int fd, off_t offset,
+  size_t length, char *buffer)
+{
+  size_t slot;
+  if(unused.empty())
+  {
+    slot = requests.size();
+    requests.push_back(Request());
+  }
+  else
+  {
+    slot = unused.back();
+    unused.pop_back();
+  }
+  Request r = {nextId++, fd, offset, length, buffer, Clock::now(), true};
+  requests[slot] = r;
+
+  Position pos = {static_cast<unsigned long long>(fd),
+    static_cast<unsigned long long>(offset)};
+  bool now = ahead(pos);
+  bool down = (now || mode == CSCAN) ? descending : !descending;
+  Entry e = {keyOf(pos, down), r.id, slot};
+  sweeps[now ? current : 01 - current].insert(e);
+  arrivals.push_back(e);
+  ++pending;
+  return r.id;
+}
+
+/**
+ *  @brief Issue the next read and report the requests it completes.
+ *
+ *  Serves the oldest request alone if it has exceeded maxLatency, otherwise
+ *  the next requests of the sweep coalesced into one read.
+ *
+ *  Complexity:\n
+ *    O(k log(n)) plus one pread() where k is the number of requests
+ *    completed and n is size().
+ *
+ *  @param out an IoCompletion per completed request is appended to it.
+ *  @return the number of requests completed, 0 if none were pending.
+ */
+inline size_t IoScheduler::dispatch(std::vector<IoCompletion> &out)
+{
+  if(pending == 0)
+  {
+    return 0;
+  }
+
+  size_t slot;
+  if(expired(slot))
+  {
+    Request &r = requests[slot];
+    ssize_t n = pread(r.fd, r.buffer, r.length, r.offset);
+    complete(slot, n < 0 ? -errno : n, out);
+    return 01;
+  }
+
+  Entry first = Entry();
+  if(!popLive(sweeps[current], first))
+  {
+    current = 01 - current;
+    if(mode == SCAN)
+    {
+      descending = !descending;
+    }
+    else
+    {
+      head.file = 0;
+      head.offset = 0;
+    }
+    popLive(sweeps[current], first);
+  }
+
+  PriorityQueue<Entry> &sweep = sweeps[current];
+  int fd = requests[first.slot].fd;
+  off_t lo = requests[first.slot].offset;
+  off_t hi = lo + static_cast<off_t>(requests[first.slot].length);
+  batch.assign(01, first.slot);
+  while(sweep.size() != 0)
+  {
+    Entry e = sweep.min();
+    const Request &r = requests[e.slot];
+    if(!r.live || r.id != e.id)
+    {
+      sweep.removeMin();
+      continue;
+    }
+    off_t end = r.offset + static_cast<off_t>(r.length);
+    if(r.fd != fd || r.offset > hi || end < lo ||
+      static_cast<size_t>(std::max(hi, end) - std::min(lo, r.offset)) >
+        maxCoalesce)
+    {
+      break;
+    }
+    sweep.removeMin();
+    batch.push_back(e.slot);
+    lo = std::min(lo, r.offset);
+    hi = std::max(hi, end);
+  }
+  head.file = static_cast<unsigned long long>(fd);
+  head.offset = static_cast<unsigned long long>(descending ? lo : hi);
+
+  if(batch.size() == 01)
+  {
+    Request &r = requests[first.slot];
+    ssize_t n = pread(r.fd, r.buffer, r.length, r.offset);
+    complete(first.slot, n < 0 ? -errno : n, out);
+    return 01;
+  }
+
+  scratch.resize(static_cast<size_t>(hi - lo));
+  ssize_t n = pread(fd, scratch.data(), scratch.size(), lo);
+  ssize_t error = n < 0 ? -errno : 0;
+  for(size_t i = 0; i < batch.size(); ++i)
+  {
+    Request &r = requests[batch[i]];
+    ssize_t got = error;
+    if(n >= 0)
+    {
+      off_t skip = r.offset - lo;
+      got = n > skip ? std::min(static_cast<ssize_t>(r.length), n - skip) : 0;
+      if(got != 0)
+      {
+        std::memcpy(r.buffer, scratch.data() + skip, static_cast<size_t>(got));
+      }
+    }
+    complete(batch[i], got, out);
+  }
+  return batch.size();
+}
+
+/**
+ *  @brief Sort key of a position in a sweep direction.
+ *
+ *  @param pos position on disk.
+ *  @param down whether the sweep descends.
+ *  @return pos, complemented for descending sweeps.
+ */
+inline IoScheduler::Position IoScheduler::keyOf(const Position &pos,
+  bool down) noexcept
+{
+  Position key = {down ? ~pos.file : pos.file,
+    down ? ~pos.offset : pos.offset};
+  return key;
+}
+
+/**
+ *  @brief Whether the current sweep has yet to pass a position.
+ *
+ *  @param pos position on disk.
+ */
+inline bool IoScheduler::ahead(const Position &pos) const noexcept
+{
+  return descending ? !(head < pos) : !(pos < head);
+}
+
+/**
+ *  @brief Pop the next live entry of a sweep, dropping stale ones.
+ *
+ *  @param sweep sweep to pop from.
+ *  @param out set to the popped entry.
+ *  @return false if the sweep held no live entry.
+ */
+inline bool IoScheduler::popLive(PriorityQueue<Entry> &sweep, Entry &out)
+{
+  while(sweep.size() != 0)
+  {
+    out = sweep.removeMin();
+    if(requests[out.slot].live && requests[out.slot].id == out.id)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ *  @brief Find the oldest pending request if it has exceeded maxLatency.
+ *
+ *  @param slot set to the slot of that request.
+ *  @return whether such a request exists.
+ */
+inline bool IoScheduler::expired(size_t &slot)
+{
+  while(!arrivals.empty())
+  {
+    const Entry &e = arrivals.front();
+    const Request &r = requests[e.slot];
+    if(!r.live || r.id != e.id)
+    {
+      arrivals.pop_front();
+      continue;
+    }
+    if(Clock::now() - r.submitted < maxLatency)
+    {
+      return false;
+    }
+    slot = e.slot;
+    arrivals.pop_front();
+    return true;
+  }
+  return false;
+}
+
+/**
+ *  @brief Report a request as completed and free its slot.
+ *
+ *  @param slot slot of the request.
+ *  @param result bytes read or -errno.
+ *  @param out the IoCompletion is appended to it.
+ */
+inline void IoScheduler::complete(size_t slot, ssize_t result,
+  std::vector<IoCompletion> &out)
+{
+  IoCompletion c = {requests[slot].id, result};
+  out.push_back(c);
+  requests[slot].live = false;
+  unused.push_back(slot);
+  --pending;
+}
@@ -0,0 +1,124 @@
+#ifndef KEY_CACHING_QUEUE_H
+#define KEY_CACHING_QUEUE_H
+#include <type_traits>
+#include <utility>
+#include "priority_queue.h"
+
+/**
+ *  KeyCachingQueue class defines a min-heap ordered by a projection of its
+ *  entries that is computed once per entry instead of once per comparison.
+ *
+ *  <p>
+ *  A PriorityQueue with a Key projects both sides of every comparison, so an
+ *  entry is projected O(log(n)) times while it sifts. That is free for a
+ *  MemberKey but not for a projection doing a hash lookup or computing a
+ *  score. KeyCachingQueue projects each entry once on insert() and stores
+ *  the result next to it, the heap then only compares the cached keys.
+ *  </p>
+ *
+ *  <p>
+ *  The cached key is never refreshed. If the projection of an entry changes
+ *  while it is queued, the entry keeps its position for the old key.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the KeyCachingQueue().
+ *    Key projection applied once to each entry, its result is cached.
+ *    Tuning arity and prefetch distance of the heap, defaults to the tuning
+ *      for the size of an entry and its cached key.
+ *
+ *  Member Variables:\n
+ *    project projection computing the key of new entries.
+ *    queue PriorityQueue of Entry ordered by the cached key.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor, optionally taking the projection.
+ *    - size() return logical size.
+ *    - min() return the minimum entry.
+ *    - minKey() return the cached key of the minimum entry.
+ *    - removeMin() remove the minimum entry and return it.
+ *    - insert() insert a new entry, projecting it once.
+ *  </p>
+ */
+template <class T, class Key,
+  class Tuning = PriorityQueueTuning<sizeof(std::pair<typename std::decay<
+    decltype(std::declval<const Key &>()(std::declval<const T &>()))>::type,
+    T>)> >
+class KeyCachingQueue
+{
+  public:
+    typedef typename std::decay<decltype(std::declval<const Key &>()(
+      std::declval<const T &>()))>::type KeyType;
+    explicit KeyCachingQueue(const Key & = Key());
+    size_t size() const noexcept;
+    T min() const;
+    KeyType minKey() const;
+    T removeMin();
+    void insert(T);
+
+  private:
+    /**
+     *  Entry is a queued entry with its cached key, the key first so the
+     *  comparisons of a sift read the front of each entry.
+     */
+    struct Entry
+    {
+      KeyType key;
+      T val;
+    };
+    Key project;
+    PriorityQueue<Entry, MemberKey<Entry, KeyType>, Tuning> queue;
+};
+
+/**
+ *  Indirect is a projection of pointers that applies Key to the pointee.
+ *
+ *  <p>
+ *  As the Key of a PriorityQueue of pointers it orders them by their
+ *  objects, but every comparison then dereferences both sides, one cache
+ *  miss each when the objects are cold. As the Key of a KeyCachingQueue,
+ *  see IndirectQueue, the pointee is read once on insert.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the objects pointed to.
+ *    Key projection of T, defaults to Identity.
+ */
+template <class T, class Key = Identity<T> >
+struct Indirect
+{
+  Key key;
+  typename std::decay<decltype(std::declval<const Key &>()(
+    std::declval<const T &>()))>::type operator()(const T *p) const
+  {
+    return key(*p);
+  }
+};
+
+/**
+ *  @brief Make an Indirect projection applying a key to the pointee.
+ *
+ *  @param key projection of the objects pointed to.
+ */
+template <class T, class Key>
+Indirect<T, Key> indirect(const Key &key)
+{
+  Indirect<T, Key> p = {key};
+  return p;
+}
+
+/**
+ *  IndirectQueue is a min-heap of pointers to T stored as (key, pointer)
+ *  pairs. Comparisons only read the cached keys, a pointer is followed once
+ *  when it is inserted and never again by the queue.
+ *
+ *  Template Parameters:\n
+ *    T Type of the objects pointed to by the entries.
+ *    Key projection of T the entries are ordered by, defaults to Identity.
+ */
+template <class T, class Key = Identity<T> >
+using IndirectQueue = KeyCachingQueue<T *, Indirect<T, Key> >;
+
+#include "key_caching_queue.hxx"
+#endif
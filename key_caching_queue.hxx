@@ -0,0 +1,101 @@
+/**
+ *  @brief Constructs an empty KeyCachingQueue.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection whose result is cached.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param project projection computing the key of new entries.
+ */
+template <class T, class Key, class Tuning>
+KeyCachingQueue<T, Key, Tuning>::KeyCachingQueue(const Key &project) :
+  project(project), queue(memberKey(&Entry::key))
+{
+}
+
+/**
+ *  @brief Returns the number of entries.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection whose result is cached.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Key, class Tuning>
+size_t KeyCachingQueue<T, Key, Tuning>::size() const noexcept
+{
+  return queue.size();
+}
+
+/**
+ *  @brief Returns the minimum entry without removing it.
+ *
+ *  Precondition:\n
+ *    size() > 0
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection whose result is cached.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @return T the minimum entry.
+ */
+template <class T, class Key, class Tuning>
+T KeyCachingQueue<T, Key, Tuning>::min() const
+{
+  return queue.min().val;
+}
+
+/**
+ *  @brief Returns the key cached for the minimum entry.
+ *
+ *  Precondition:\n
+ *    size() > 0
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection whose result is cached.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @return the key the minimum entry was projected to when inserted.
+ */
+template <class T, class Key, class Tuning>
+typename KeyCachingQueue<T, Key, Tuning>::KeyType
+  KeyCachingQueue<T, Key, Tuning>::minKey() const
+{
+  return queue.min().key;
+}
+
+/**
+ *  @brief Removes the minimum entry and returns it.
+ *
+ *  Complexity:\n
+ *    O(log(n)) comparisons of cached keys, where n is size(). The
+ *    projection is not called.
+ *
+ *  Precondition:\n
+ *    size() > 0
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection whose result is cached.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @return T the minimum entry.
+ */
+template <class T, class Key, class Tuning>
+T KeyCachingQueue<T, Key, Tuning>::removeMin()
+{
+  return queue.removeMin().val;
+}
+
+/**
+ *  @brief Inserts a new entry, projecting it exactly once.
+ *
+ *  Complexity:\n
+ *    One call of the projection plus O(log(n)) amortized comparisons of
+ *    cached keys, where n is size().
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection whose result is cached.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param val new object to be stored, will be copied.
+ */
+template <class T, class Key, class Tuning>
+void KeyCachingQueue<T, Key, Tuning>::insert(T val)
+{
+  Entry e = {project(val), val};
+  queue.insert(e);
+}
@@ -0,0 +1,100 @@
+#ifndef KNN_H
+#define KNN_H
+#include <vector>
+#include "bounded_heap.h"
+
+/**
+ *  Neighbor is a search result, ordered by distance and then by id so that
+ *  results do not depend on scan order or thread count.
+ */
+struct Neighbor
+{
+  float distance;
+  unsigned id;
+  bool operator<(const Neighbor &o) const noexcept
+  {
+    return distance < o.distance || (distance == o.distance && id < o.id);
+  }
+};
+
+/**
+ *  SquaredL2 is the squared euclidean distance between two vectors.
+ */
+struct SquaredL2
+{
+  inline float operator()(const float *, const float *, size_t) const
+    noexcept;
+};
+
+/**
+ *  NegativeDot is the negated inner product of two vectors, a distance for
+ *  inner product and, over normalized vectors, cosine similarity search.
+ */
+struct NegativeDot
+{
+  inline float operator()(const float *, const float *, size_t) const
+    noexcept;
+};
+
+/**
+ *  KnnIndex class defines brute force k-nearest-neighbour search over a
+ *  contiguous array of float vectors.
+ *
+ *  <p>
+ *  A query computes its distance to every vector and keeps the k nearest
+ *  in a BoundedHeap, so a candidate farther than the current k-th nearest
+ *  is rejected by one comparison and never touches the heap. Distances are
+ *  computed eight lanes at a time with GCC vector extensions, which build
+ *  to SSE by default and to AVX with -mavx or -march=native.
+ *  </p>
+ *
+ *  <p>
+ *  With several threads each scans a contiguous slice of the vectors into
+ *  its own BoundedHeap, and the heaps are merged at the end. Since Neighbor
+ *  breaks ties by id the result equals the single threaded one.
+ *  </p>
+ *
+ *  <p>
+ *  The vectors are not copied, they must outlive the index.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    Distance functor computing the distance between two vectors of a
+ *      given dimension, defaults to SquaredL2.
+ *
+ *  Member Variables:\n
+ *    vectors the vectors, row after row.
+ *    count number of vectors.
+ *    dim number of floats per vector.
+ *    distance the distance functor.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) view count vectors of dim floats.
+ *    - size() return the number of vectors.
+ *    - dimension() return the number of floats per vector.
+ *    - search() return the k nearest vectors of a query, nearest first,
+ *        optionally splitting the scan over threads.
+ *    - scan() private helper offer a range of vectors to a heap.
+ *  </p>
+ */
+template <class Distance = SquaredL2>
+class KnnIndex
+{
+  public:
+    KnnIndex(const float *, size_t, size_t, const Distance & = Distance());
+    size_t size() const noexcept;
+    size_t dimension() const noexcept;
+    void search(const float *, size_t, std::vector<Neighbor> &,
+      size_t = 01) const;
+
+  private:
+    void scan(const float *, size_t, size_t, BoundedHeap<Neighbor> &) const;
+    const float *vectors;
+    size_t count;
+    size_t dim;
+    Distance distance;
+};
+
+#include "knn.hxx"
+#endif
@@ -0,0 +1,207 @@
+#include <cstring>
+#include <functional>
+#include <thread>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  The distance kernels keep two accumulators of eight lanes so consecutive
+ *  additions do not wait on each other, load with memcpy so rows need no
+ *  particular alignment, and finish the last dim % 16 floats one at a time.
+ *  </p>
+ */
+
+/**
+ *  KnnLanes is eight floats operated on together.
+ */
+typedef float KnnLanes __attribute__((vector_size(0x20)));
+
+/**
+ *  @brief Returns the sum of the lanes of a vector.
+ *
+ *  @param v the vector.
+ */
+inline float knnSum(const KnnLanes &v) noexcept
+{
+  float sum = 0;
+  for(size_t i = 0; i < sizeof(KnnLanes) / sizeof(float); ++i)
+  {
+    sum += v[i];
+  }
+  return sum;
+}
+
+/**
+ *  @brief Returns the squared euclidean distance between two vectors.
+ *
+ *  Complexity:\n
+ *    O(dim), sixteen floats per step.
+ *
+ *  @param a the first vector.
+ *  @param b the second vector.
+ *  @param dim number of floats per vector.
+ */
+inline float SquaredL2::operator()(const float *a, const float *b,
+  size_t dim) const noexcept
+{
+  const size_t lanes = sizeof(KnnLanes) / sizeof(float);
+  KnnLanes s0 = {0}, s1 = {0}, x, y;
+  size_t i = 0;
+  for(; i + 02 * lanes <= dim; i += 02 * lanes)
+  {
+    std::memcpy(&x, a + i, sizeof(x));
+    std::memcpy(&y, b + i, sizeof(y));
+    x -= y;
+    s0 += x * x;
+    std::memcpy(&x, a + i + lanes, sizeof(x));
+    std::memcpy(&y, b + i + lanes, sizeof(y));
+    x -= y;
+    s1 += x * x;
+  }
+  float sum = knnSum(s0 + s1);
+  for(; i < dim; ++i)
+  {
+    float d = a[i] - b[i];
+    sum += d * d;
+  }
+  return sum;
+}
+
+/**
+ *  @brief Returns the negated inner product of two vectors.
+ *
+ *  Complexity:\n
+ *    O(dim), sixteen floats per step.
+ *
+ *  @param a the first vector.
+ *  @param b the second vector.
+ *  @param dim number of floats per vector.
+ */
+inline float NegativeDot::operator()(const float *a, const float *b,
+  size_t dim) const noexcept
+{
+  const size_t lanes = sizeof(KnnLanes) / sizeof(float);
+  KnnLanes s0 = {0}, s1 = {0}, x, y;
+  size_t i = 0;
+  for(; i + 02 * lanes <= dim; i += 02 * lanes)
+  {
+    std::memcpy(&x, a + i, sizeof(x));
+    std::memcpy(&y, b + i, sizeof(y));
+    s0 += x * y;
+    std::memcpy(&x, a + i + lanes, sizeof(x));
+    std::memcpy(&y, b + i + lanes, sizeof(y));
+    s1 += x * y;
+  }
+  float sum = knnSum(s0 + s1);
+  for(; i < dim; ++i)
+  {
+    sum += a[i] * b[i];
+  }
+  return -sum;
+}
+
+/**
+ *  @brief Constructs an index over count vectors of dim floats.
+ *
+ *  @tparam Distance the distance functor.
+ *  @param vectors the vectors, row after row, not copied.
+ *  @param count number of vectors.
+ *  @param dim number of floats per vector.
+ *  @param distance the distance functor.
+ */
+template <class Distance>
+KnnIndex<Distance>::KnnIndex(const float *vectors, size_t count, size_t dim,
+  const Distance &distance) :
+  vectors(vectors), count(count), dim(dim), distance(distance)
+{
+}
+
+/**
+ *  @brief Returns the number of vectors.
+ *
+ *  @tparam Distance the distance functor.
+ */
+template <class Distance>
+size_t KnnIndex<Distance>::size() const noexcept
+{
+  return count;
+}
+
+/**
+ *  @brief Returns the number of floats per vector.
+ *
+ *  @tparam Distance the distance functor.
+ */
+template <class Distance>
+size_t KnnIndex<Distance>::dimension() const noexcept
+{
+  return dim;
+}
+
+/**
+ *  @brief Finds the k vectors nearest to a query.
+ *
+ *  Complexity:\n
+ *    O(n dim / p + n log(k) / p + p k log(k)) where n is size() and p the
+ *    number of threads, with the n log(k) term only for the candidates that
+ *    improve on the k-th nearest, which are few once the heap is full.
+ *
+ *  @tparam Distance the distance functor.
+ *  @param query dimension() floats.
+ *  @param k number of neighbours wanted.
+ *  @param out replaced by min(k, size()) neighbours, nearest first.
+ *  @param threads number of threads scanning, 0 or 1 scans on the caller.
+ */
+template <class Distance>
+void KnnIndex<Distance>::search(const float *query, size_t k,
+  std::vector<Neighbor> &out, size_t threads) const
+{
+  if(threads > count)
+  {
+    threads = count;
+  }
+  if(threads == 0)
+  {
+    threads = 01;
+  }
+  std::vector<BoundedHeap<Neighbor> > parts;
+  parts.reserve(threads);
+  for(size_t t = 0; t < threads; ++t)
+  {
+    parts.emplace_back(k); //copies would not keep the reserved room
+  }
+  std::vector<std::thread> workers;
+  for(size_t t = 01; t < threads; ++t)
+  {
+    workers.push_back(std::thread(&KnnIndex::scan, this, query,
+      count * t / threads, count * (t + 01) / threads, std::ref(parts[t])));
+  }
+  scan(query, 0, count / threads, parts[0]);
+  for(size_t t = 01; t < threads; ++t)
+  {
+    workers[t - 01].join();
+    parts[0].merge(parts[t]);
+  }
+  parts[0].drain(out);
+}
+
+/**
+ *  @brief Offer the vectors of a range to a heap.
+ *
+ *  @tparam Distance the distance functor.
+ *  @param query dimension() floats.
+ *  @param begin the first vector.
+ *  @param end one past the last vector.
+ *  @param best heap of the nearest neighbours so far.
+ */
+template <class Distance>
+void KnnIndex<Distance>::scan(const float *query, size_t begin, size_t end,
+  BoundedHeap<Neighbor> &best) const
+{
+  const float *row = vectors + begin * dim;
+  for(size_t i = begin; i < end; ++i, row += dim)
+  {
+    Neighbor n = {distance(query, row, dim), (unsigned)i};
+    best.offer(n);
+  }
+}
@@ -0,0 +1,115 @@
+#ifndef MOUND_H
+#define MOUND_H
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+
+/**
+ *  Mound class defines a concurrent min-heap of sorted lists, after the
+ *  mound of Liu and Spear.
+ *
+ *  <p>
+ *  Like PriorityQueue the mound is an implicit tree laid out level by level
+ *  in arrays, but each node holds a sorted list instead of one entry, and
+ *  heap order holds between the heads of the lists. insert() picks a random
+ *  leaf whose head is not smaller than the new entry and binary searches the
+ *  path from the root to it for the highest such node, reading heads
+ *  without locking. Only that node and its parent are then locked, to check
+ *  that the search is still valid and prepend the entry. Most inserts
+ *  therefore touch O(log(log(n))) nodes and contend on nothing near the
+ *  root. tryRemoveMin() pops the root's head and restores heap order by
+ *  swapping whole lists down one path, like removeMin() of a heap.
+ *  </p>
+ *
+ *  <p>
+ *  This is the fine-grained locking mound of the paper. Its lock-free
+ *  variant swaps parent and child lists with a double compare and swap on
+ *  two non-adjacent words, which C++11 has no portable way to express. The
+ *  node locks are test and test-and-set bits acquired in increasing node
+ *  order, so inserts and removals cannot deadlock, and heads are atomics so
+ *  the unlocked search reads never race.
+ *  </p>
+ *
+ *  <p>
+ *  Heads are read without locking, so T must be trivially copyable. Entries
+ *  of up to 8 bytes keep those reads lock free, larger ones may need
+ *  linking with -latomic.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the Mound().
+ *
+ *  Member Variables:\n
+ *    levels nodes of each level of the tree, allocated as the tree grows.
+ *    depth number of allocated levels.
+ *    count number of entries.
+ *    grow mutex serializing the allocation of levels.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor.
+ *    - (Destructor) public destructor.
+ *    - size() return the number of entries, approximate under concurrent
+ *        modification.
+ *    - insert() insert a new entry.
+ *    - tryRemoveMin() remove the minimum entry if there is one.
+ *    - node() private helper return the node at a position.
+ *    - below() private helper return whether an entry is at most a node's
+ *        head, an empty node's head being infinite.
+ *    - lock(), unlock() private helpers lock or unlock a node.
+ *    - pop() private helper remove the head of a locked node's list.
+ *    - moundify() private helper restore heap order below a locked node.
+ *    - addLevel() private helper allocate the next level.
+ *  </p>
+ */
+template <class T>
+class Mound
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+    "heads are read while they may be rewritten");
+
+  public:
+    Mound();
+    ~Mound();
+    size_t size() const noexcept;
+    void insert(T);
+    bool tryRemoveMin(T &);
+
+  private:
+    /**
+     *  List is a cell of a node's sorted list.
+     */
+    struct List
+    {
+      T val;
+      List *next;
+    };
+
+    /**
+     *  Node is a node of the tree: its list, a copy of the list's head
+     *  readable without locking, and its lock.
+     */
+    struct Node
+    {
+      std::atomic<bool> locked;
+      std::atomic<bool> full;
+      std::atomic<T> head;
+      List *list;
+    };
+
+    static const size_t maxLevels = 040;
+    Node &node(size_t) const noexcept;
+    bool below(const T &, size_t) const noexcept;
+    void lock(size_t) noexcept;
+    void unlock(size_t) noexcept;
+    void pop(size_t) noexcept;
+    void moundify(size_t) noexcept;
+    void addLevel(size_t);
+    std::atomic<Node *> levels[maxLevels];
+    std::atomic<size_t> depth;
+    std::atomic<size_t> count;
+    std::mutex grow;
+};
+
+#include "mound.hxx"
+#endif
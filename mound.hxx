@@ -0,0 +1,356 @@
+#include <random>
+#include <thread>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  Positions are 1-based as in PriorityQueue: level l holds positions
+ *  2^l up to 2^(l+1) - 1, the children of n are 2n and 2n + 1. Levels are
+ *  never freed while the Mound lives, so a position once allocated stays
+ *  valid, and a new level starts with every node empty, which cannot break
+ *  heap order.
+ *  </p>
+ *
+ *  <p>
+ *  Every lock is taken in increasing position order: insert() locks a parent
+ *  before its child, moundify() holds a node while locking its children and
+ *  only keeps the child it descends to. The list of a node is read and
+ *  written only under its lock, while full and head mirror it for the
+ *  unlocked search in insert(). The search may be misled by concurrent
+ *  changes, it is only a hint that insert() validates under lock.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty Mound holding only the root level.
+ *
+ *  @tparam T type of object stored.
+ */
+template <class T>
+Mound<T>::Mound() : depth(0), count(0)
+{
+  for(size_t l = 0; l < maxLevels; ++l)
+  {
+    levels[l].store(NULL, std::memory_order_relaxed);
+  }
+  addLevel(0);
+}
+
+/**
+ *  @brief Destroys the Mound and its remaining entries.
+ *
+ *  @tparam T type of object stored.
+ */
+template <class T>
+Mound<T>::~Mound()
+{
+  for(size_t l = 0; l < depth.load(std::memory_order_relaxed); ++l)
+  {
+    Node *level = levels[l].load(std::memory_order_relaxed);
+    for(size_t i = 0; i < (size_t)01 << l; ++i)
+    {
+      while(List *c = level[i].list)
+      {
+        level[i].list = c->next;
+        delete c;
+      }
+    }
+    delete[] level;
+  }
+}
+
+/**
+ *  @brief Returns the number of entries.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @tparam T type of object stored.
+ */
+template <class T>
+size_t Mound<T>::size() const noexcept
+{
+  return count.load(std::memory_order_relaxed);
+}
+
+/**
+ *  @brief Inserts a new entry at the top of the list of the highest node on
+ *  a random root to leaf path whose head is not smaller.
+ *
+ *  Complexity:\n
+ *    O(log(log(n))) node reads and two node locks expected, where n is the
+ *    number of nodes.
+ *
+ *  @tparam T type of object stored.
+ *  @param val new object to be stored, will be copied.
+ */
+template <class T>
+void Mound<T>::insert(T val)
+{
+  static const int attempts = 010;
+  static thread_local std::minstd_rand random(
+    std::hash<std::thread::id>()(std::this_thread::get_id()));
+  List *cell = new List;
+  cell->val = val;
+  for(;;)
+  {
+    size_t height = depth.load(std::memory_order_acquire);
+    size_t first = (size_t)01 << (height - 01);
+    size_t leaf = 0;
+    for(int a = 0; a < attempts && !leaf; ++a)
+    {
+      size_t n = first + random() % first;
+      leaf = below(val, n) ? n : 0;
+    }
+    if(!leaf)
+    {
+      addLevel(height);
+      continue;
+    }
+
+    size_t lo = 0;
+    size_t hi = height - 01;
+    while(lo < hi)
+    {
+      size_t mid = (lo + hi) / 02;
+      if(below(val, leaf >> (height - 01 - mid)))
+      {
+        hi = mid;
+      }
+      else
+      {
+        lo = mid + 01;
+      }
+    }
+    size_t n = leaf >> (height - 01 - hi);
+
+    if(n > 01)
+    {
+      lock(n / 02);
+    }
+    lock(n);
+    Node &target = node(n);
+    bool valid = below(val, n) && (n == 01 || (node(n / 02).list &&
+      !(val < node(n / 02).list->val)));
+    if(valid)
+    {
+      cell->next = target.list;
+      target.list = cell;
+      target.head.store(val, std::memory_order_relaxed);
+      target.full.store(true, std::memory_order_relaxed);
+      count.fetch_add(01, std::memory_order_relaxed);
+    }
+    unlock(n);
+    if(n > 01)
+    {
+      unlock(n / 02);
+    }
+    if(valid)
+    {
+      return;
+    }
+  }
+}
+
+/**
+ *  @brief Removes the minimum entry, the head of the root's list, if there
+ *  is one.
+ *
+ *  Complexity:\n
+ *    O(log(n)) node locks, where n is the number of nodes.
+ *
+ *  @tparam T type of object stored.
+ *  @param out set to the removed entry.
+ *  @return false if the Mound was empty.
+ */
+template <class T>
+bool Mound<T>::tryRemoveMin(T &out)
+{
+  lock(01);
+  Node &root = node(01);
+  if(!root.list)
+  {
+    unlock(01);
+    return false;
+  }
+  out = root.list->val;
+  pop(01);
+  count.fetch_sub(01, std::memory_order_relaxed);
+  moundify(01);
+  return true;
+}
+
+/**
+ *  @brief Returns the node at a position.
+ *
+ *  @tparam T type of object stored.
+ *  @param n 1-based position, on an allocated level.
+ */
+template <class T>
+inline typename Mound<T>::Node &Mound<T>::node(size_t n) const noexcept
+{
+#ifdef __GNUC__
+  size_t l = sizeof(unsigned long long) * 010 - 01 - __builtin_clzll(n);
+#else
+  size_t l = 0;
+  while(n >> (l + 01))
+  {
+    ++l;
+  }
+#endif
+  return levels[l].load(std::memory_order_acquire)[n - ((size_t)01 << l)];
+}
+
+/**
+ *  @brief Returns whether an entry may go above a node's list, which holds
+ *  for any entry when the node is empty.
+ *
+ *  Read without locking unless the caller holds the node's lock.
+ *
+ *  @tparam T type of object stored.
+ *  @param val the entry.
+ *  @param n position of the node.
+ */
+template <class T>
+inline bool Mound<T>::below(const T &val, size_t n) const noexcept
+{
+  const Node &at = node(n);
+  return !at.full.load(std::memory_order_relaxed) ||
+    !(at.head.load(std::memory_order_relaxed) < val);
+}
+
+/**
+ *  @brief Lock a node, yielding while it is held by another thread.
+ *
+ *  @tparam T type of object stored.
+ *  @param n position of the node.
+ */
+template <class T>
+inline void Mound<T>::lock(size_t n) noexcept
+{
+  std::atomic<bool> &locked = node(n).locked;
+  while(locked.exchange(true, std::memory_order_acquire))
+  {
+    while(locked.load(std::memory_order_relaxed))
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+/**
+ *  @brief Unlock a node.
+ *
+ *  @tparam T type of object stored.
+ *  @param n position of the node.
+ */
+template <class T>
+inline void Mound<T>::unlock(size_t n) noexcept
+{
+  node(n).locked.store(false, std::memory_order_release);
+}
+
+/**
+ *  @brief Remove the head of a locked, non-empty node's list.
+ *
+ *  @tparam T type of object stored.
+ *  @param n position of the node.
+ */
+template <class T>
+void Mound<T>::pop(size_t n) noexcept
+{
+  Node &at = node(n);
+  List *c = at.list;
+  at.list = c->next;
+  if(at.list)
+  {
+    at.head.store(at.list->val, std::memory_order_relaxed);
+  }
+  at.full.store(at.list != NULL, std::memory_order_relaxed);
+  delete c;
+}
+
+/**
+ *  @brief Restore heap order below a locked node whose head may have grown,
+ *  swapping its list with its least child's while that is smaller, and
+ *  unlock it.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is the number of nodes.
+ *
+ *  @tparam T type of object stored.
+ *  @param n position of the locked node.
+ */
+template <class T>
+void Mound<T>::moundify(size_t n) noexcept
+{
+  for(;;)
+  {
+    size_t height = depth.load(std::memory_order_acquire);
+    if(n >= (size_t)01 << (height - 01))
+    {
+      unlock(n);
+      return;
+    }
+    size_t left = 02 * n;
+    size_t right = left + 01;
+    lock(left);
+    lock(right);
+    Node &at = node(n);
+    Node &l = node(left);
+    Node &r = node(right);
+    size_t least = r.list && (!l.list || r.list->val < l.list->val) ?
+      right : left;
+    size_t other = least == left ? right : left;
+    Node &c = node(least);
+    if(!c.list || (at.list && !(c.list->val < at.list->val)))
+    {
+      unlock(right);
+      unlock(left);
+      unlock(n);
+      return;
+    }
+
+    List *swap = at.list;
+    at.list = c.list;
+    c.list = swap;
+    at.head.store(at.list->val, std::memory_order_relaxed);
+    at.full.store(true, std::memory_order_relaxed);
+    if(c.list)
+    {
+      c.head.store(c.list->val, std::memory_order_relaxed);
+    }
+    c.full.store(c.list != NULL, std::memory_order_relaxed);
+    unlock(other);
+    unlock(n);
+    n = least;
+  }
+}
+
+/**
+ *  @brief Allocate the level below the given number of levels, unless
+ *  another thread already did.
+ *
+ *  @tparam T type of object stored.
+ *  @param height the number of levels the caller saw.
+ */
+template <class T>
+void Mound<T>::addLevel(size_t height)
+{
+  std::lock_guard<std::mutex> guard(grow);
+  if(depth.load(std::memory_order_relaxed) != height || height == maxLevels)
+  {
+    return;
+  }
+  size_t width = (size_t)01 << height;
+  Node *level = new Node[width];
+  for(size_t i = 0; i < width; ++i)
+  {
+    level[i].locked.store(false, std::memory_order_relaxed);
+    level[i].full.store(false, std::memory_order_relaxed);
+    level[i].head.store(T(), std::memory_order_relaxed);
+    level[i].list = NULL;
+  }
+  levels[height].store(level, std::memory_order_release);
+  depth.store(height + 01, std::memory_order_release);
+}
@@ -0,0 +1,129 @@
+#ifndef ORDER_BOOK_H
+#define ORDER_BOOK_H
+#include <utility>
+#include <vector>
+#include "indexed_heap.h"
+
+/**
+ *  OrderBook class defines a price-time priority limit order book, the
+ *  matching core of an exchange or exchange simulator.
+ *
+ *  <p>
+ *  Each side is an IndexedHeap of resting order ids keyed by (price,
+ *  sequence), highest price first for bids and lowest first for asks, with
+ *  earlier arrivals first within a price. An incoming order matches against
+ *  the top of the opposite side while the prices cross, and its remainder
+ *  rests. Since the heaps track where every order is, cancel() removes an
+ *  order in O(log(n)) on the spot, instead of marking it in a lazily
+ *  checked set while it keeps occupying the heap.
+ *  </p>
+ *
+ *  <p>
+ *  Order ids are dense, below the capacity given to the constructor, and
+ *  may be reused once the order is gone. Prices are integer ticks within a
+ *  range fixed at construction, and the quantity and order count at every
+ *  price are kept in a flat array per side, so level queries are O(1).
+ *  Every array and heap is sized up front, so submit() and cancel() never
+ *  allocate.
+ *  </p>
+ *
+ *  Member Variables:\n
+ *    price, sequence, remaining, side per order id.
+ *    low, high the price range.
+ *    nextSequence sequence of the next resting order.
+ *    bidLevels, askLevels totals per price of each side.
+ *    bids, asks IndexedHeap of resting orders of each side.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) size the book for a number of ids and a price range.
+ *    - size() return the number of resting orders.
+ *    - contains() return whether an order rests in the book.
+ *    - sideOf(), priceOf(), quantityOf() return a resting order's fields.
+ *    - best() return the best level of a side.
+ *    - level() return the totals at one price of a side.
+ *    - depth() copy up to n best levels of a side.
+ *    - submit() match an incoming limit order, resting any remainder.
+ *    - cancel() remove a resting order.
+ *    - heapOf(), levelsOf() private helpers select a side's structures.
+ *  </p>
+ */
+class OrderBook
+{
+  public:
+    typedef long long Price;
+    typedef unsigned long long Quantity;
+
+    /**
+     *  Side of an order.
+     */
+    enum Side { buy, sell };
+
+    /**
+     *  Level is the total of the orders resting at one price.
+     */
+    struct Level
+    {
+      Price price;
+      Quantity quantity;
+      unsigned orders;
+    };
+
+    OrderBook(size_t, Price, Price);
+    OrderBook(const OrderBook &) = delete;
+    OrderBook &operator=(const OrderBook &) = delete;
+    size_t size() const noexcept;
+    bool contains(unsigned) const noexcept;
+    Side sideOf(unsigned) const noexcept;
+    Price priceOf(unsigned) const noexcept;
+    Quantity quantityOf(unsigned) const noexcept;
+    bool best(Side, Level &) const noexcept;
+    Level level(Side, Price) const noexcept;
+    size_t depth(Side, Level *, size_t) const noexcept;
+    template <class OnFill>
+    Quantity submit(unsigned, Side, Price, Quantity, OnFill);
+    void cancel(unsigned);
+
+  private:
+    /**
+     *  Priority projects an order id to its heap key, the price negated for
+     *  bids so the highest comes first, then the sequence.
+     */
+    struct Priority
+    {
+      const OrderBook *book;
+      Price sign;
+      std::pair<Price, unsigned long long> operator()(unsigned id) const
+        noexcept
+      {
+        return std::make_pair(sign * book->price[id], book->sequence[id]);
+      }
+    };
+
+    /**
+     *  Totals is the quantity and count of orders at one price.
+     */
+    struct Totals
+    {
+      Quantity quantity;
+      unsigned orders;
+    };
+    IndexedHeap<Priority> &heapOf(Side) noexcept;
+    const IndexedHeap<Priority> &heapOf(Side) const noexcept;
+    std::vector<Totals> &levelsOf(Side) noexcept;
+    const std::vector<Totals> &levelsOf(Side) const noexcept;
+    std::vector<Price> price;
+    std::vector<unsigned long long> sequence;
+    std::vector<Quantity> remaining;
+    std::vector<unsigned char> side;
+    Price low;
+    Price high;
+    unsigned long long nextSequence;
+    std::vector<Totals> bidLevels;
+    std::vector<Totals> askLevels;
+    IndexedHeap<Priority> bids;
+    IndexedHeap<Priority> asks;
+};
+
+#include "order_book.hxx"
+#endif
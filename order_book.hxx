@@ -0,0 +1,287 @@
+#include <stdexcept>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  A fill leaves the maker at the top of its heap, only its remaining
+ *  quantity drops, so partial fills cost no heap operation. Levels are
+ *  indexed by price - low.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty OrderBook.
+ *
+ *  @param orders number of order ids, which are below it.
+ *  @param low lowest price accepted.
+ *  @param high highest price accepted.
+ *  @throws std::invalid_argument if high < low.
+ */
+inline OrderBook::OrderBook(size_t orders, Price low, Price high) :
+  price(orders, 0), sequence(orders, 0), remaining(orders, 0),
+  side(orders, buy), low(low), high(high), nextSequence(0),
+  bids(Priority{this, -01}), asks(Priority{this, 01})
+{
+  if(high < low)
+  {
+    throw std::invalid_argument("empty price range");
+  }
+  Totals none = {0, 0};
+  bidLevels.assign(high - low + 01, none);
+  askLevels.assign(high - low + 01, none);
+  bids.reserve(orders);
+  asks.reserve(orders);
+}
+
+/**
+ *  @brief Returns the number of resting orders.
+ */
+inline size_t OrderBook::size() const noexcept
+{
+  return bids.size() + asks.size();
+}
+
+/**
+ *  @brief Returns whether an order rests in the book.
+ *
+ *  @param id the order id.
+ */
+inline bool OrderBook::contains(unsigned id) const noexcept
+{
+  return bids.contains(id) || asks.contains(id);
+}
+
+/**
+ *  @brief Returns the side of a resting order.
+ *
+ *  @param id the order id.
+ */
+inline OrderBook::Side OrderBook::sideOf(unsigned id) const noexcept
+{
+  return (Side)side[id];
+}
+
+/**
+ *  @brief Returns the limit price of a resting order.
+ *
+ *  @param id the order id.
+ */
+inline OrderBook::Price OrderBook::priceOf(unsigned id) const noexcept
+{
+  return price[id];
+}
+
+/**
+ *  @brief Returns the unfilled quantity of a resting order.
+ *
+ *  @param id the order id.
+ */
+inline OrderBook::Quantity OrderBook::quantityOf(unsigned id) const noexcept
+{
+  return remaining[id];
+}
+
+/**
+ *  @brief Returns the best level of a side, the highest bid or lowest ask.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @param s the side.
+ *  @param out set to the level.
+ *  @return false if the side is empty.
+ */
+inline bool OrderBook::best(Side s, Level &out) const noexcept
+{
+  const IndexedHeap<Priority> &heap = heapOf(s);
+  if(heap.size() == 0)
+  {
+    return false;
+  }
+  out = level(s, price[heap.top()]);
+  return true;
+}
+
+/**
+ *  @brief Returns the totals at one price of a side.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @param s the side.
+ *  @param p the price, within the range of the book.
+ */
+inline OrderBook::Level OrderBook::level(Side s, Price p) const noexcept
+{
+  const Totals &t = levelsOf(s)[p - low];
+  Level l = {p, t.quantity, t.orders};
+  return l;
+}
+
+/**
+ *  @brief Copies the best non-empty levels of a side, best first.
+ *
+ *  Complexity:\n
+ *    Linear in the number of ticks between the best price and the last
+ *    level copied.
+ *
+ *  @param s the side.
+ *  @param out array receiving the levels.
+ *  @param n room in out.
+ *  @return the number of levels copied.
+ */
+inline size_t OrderBook::depth(Side s, Level *out, size_t n) const noexcept
+{
+  Level top;
+  if(n == 0 || !best(s, top))
+  {
+    return 0;
+  }
+  const std::vector<Totals> &levels = levelsOf(s);
+  size_t copied = 0;
+  Price step = s == buy ? -01 : 01;
+  for(Price p = top.price; p >= low && p <= high && copied < n; p += step)
+  {
+    if(levels[p - low].orders != 0)
+    {
+      out[copied++] = level(s, p);
+    }
+  }
+  return copied;
+}
+
+/**
+ *  @brief Matches an incoming limit order against the opposite side, then
+ *  rests any remainder under the given id.
+ *
+ *  Resting orders are filled best price first, earliest first within a
+ *  price, at their own price, while they cross the incoming price. Each
+ *  fill is reported before the next is made. onFill must not modify the
+ *  book.
+ *
+ *  Complexity:\n
+ *    O(log(n)) per resting order filled completely or rested, where n is
+ *    size(), constant per partial fill. Never allocates.
+ *
+ *  Precondition:\n
+ *    id is below the capacity and !contains(id)
+ *
+ *  @tparam OnFill callable taking the resting order id, the price and the
+ *    quantity of a fill.
+ *  @param id id of the incoming order.
+ *  @param s side of the incoming order.
+ *  @param limit limit price of the incoming order.
+ *  @param quantity quantity of the incoming order.
+ *  @param onFill called once per fill.
+ *  @return the quantity rested, 0 if the order filled completely.
+ *  @throws std::out_of_range if the price is outside the range of the book,
+ *    before anything is matched.
+ */
+template <class OnFill>
+OrderBook::Quantity OrderBook::submit(unsigned id, Side s, Price limit,
+  Quantity quantity, OnFill onFill)
+{
+  if(limit < low || limit > high)
+  {
+    throw std::out_of_range("price outside the book");
+  }
+  Side other = s == buy ? sell : buy;
+  IndexedHeap<Priority> &makers = heapOf(other);
+  std::vector<Totals> &otherLevels = levelsOf(other);
+  while(quantity != 0 && makers.size() != 0)
+  {
+    unsigned maker = makers.top();
+    Price p = price[maker];
+    if(s == buy ? p > limit : p < limit)
+    {
+      break;
+    }
+    Quantity q = remaining[maker] < quantity ? remaining[maker] : quantity;
+    onFill(maker, p, q);
+    remaining[maker] -= q;
+    quantity -= q;
+    Totals &t = otherLevels[p - low];
+    t.quantity -= q;
+    if(remaining[maker] == 0)
+    {
+      --t.orders;
+      makers.pop();
+    }
+  }
+
+  if(quantity != 0)
+  {
+    price[id] = limit;
+    sequence[id] = nextSequence++;
+    remaining[id] = quantity;
+    side[id] = s;
+    Totals &t = levelsOf(s)[limit - low];
+    t.quantity += quantity;
+    ++t.orders;
+    heapOf(s).push(id);
+  }
+  return quantity;
+}
+
+/**
+ *  @brief Removes a resting order.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size(). Never allocates.
+ *
+ *  Precondition:\n
+ *    contains(id)
+ *
+ *  @param id the order id.
+ */
+inline void OrderBook::cancel(unsigned id)
+{
+  Side s = sideOf(id);
+  Totals &t = levelsOf(s)[price[id] - low];
+  t.quantity -= remaining[id];
+  --t.orders;
+  remaining[id] = 0;
+  heapOf(s).erase(id);
+}
+
+/**
+ *  @brief Returns the heap of a side.
+ *
+ *  @param s the side.
+ */
+inline IndexedHeap<OrderBook::Priority> &OrderBook::heapOf(Side s) noexcept
+{
+  return s == buy ? bids : asks;
+}
+
+/**
+ *  @brief Returns the heap of a side.
+ *
+ *  @param s the side.
+ */
+inline const IndexedHeap<OrderBook::Priority> &OrderBook::heapOf(Side s) const
+  noexcept
+{
+  return s == buy ? bids : asks;
+}
+
+/**
+ *  @brief Returns the totals per price of a side.
+ *
+ *  @param s the side.
+ */
+inline std::vector<OrderBook::Totals> &OrderBook::levelsOf(Side s) noexcept
+{
+  return s == buy ? bidLevels : askLevels;
+}
+
+/**
+ *  @brief Returns the totals per price of a side.
+ *
+ *  @param s the side.
+ */
+inline const std::vector<OrderBook::Totals> &OrderBook::levelsOf(Side s)
+  const noexcept
+{
+  return s == buy ? bidLevels : askLevels;
+}
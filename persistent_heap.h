@@ -0,0 +1,75 @@
+#ifndef PERSISTENT_HEAP_H
+#define PERSISTENT_HEAP_H
+#include <memory>
+
+/**
+ *  PersistentHeap class defines a purely functional min-heap with the
+ *  interface of PriorityQueue, whose copies cost O(1) and share structure.
+ *
+ *  <p>
+ *  The heap is a leftist heap of immutable reference counted nodes. insert()
+ *  and removeMin() never modify a node, they merge along right spines,
+ *  copying only the O(log(n)) nodes on the merge path and sharing the rest.
+ *  Copying a PersistentHeap copies one pointer, so a copy is a snapshot:
+ *  later operations on either copy are invisible to the other.
+ *  </p>
+ *
+ *  <p>
+ *  A single PersistentHeap object is not safe to modify from several threads
+ *  at once, but distinct copies are independent values and may be used from
+ *  different threads freely. A writer can hand snapshots to readers without
+ *  either side ever waiting on the other.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the PersistentHeap().
+ *
+ *  Member Variables:\n
+ *    root the root node, null when empty.
+ *    count number of entries.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor.
+ *    - size() return logical size.
+ *    - min() return the minimum entry.
+ *    - removeMin() remove the minimum entry and return it.
+ *    - insert() insert a new entry.
+ *    - merge() private helper merge two heaps into a new one.
+ *    - rank() private helper return the right spine length of a node.
+ *  </p>
+ */
+template <class T>
+class PersistentHeap
+{
+  public:
+    PersistentHeap();
+    size_t size() const noexcept;
+    T min() const;
+    T removeMin();
+    void insert(T);
+
+  private:
+    /**
+     *  Node is a leftist heap node. Nodes are never modified once they are
+     *  reachable from a heap, except by the destructor releasing children.
+     */
+    struct Node
+    {
+      Node(const T &, size_t, const std::shared_ptr<Node> &,
+        const std::shared_ptr<Node> &);
+      ~Node();
+      T val;
+      size_t rank;
+      std::shared_ptr<Node> left;
+      std::shared_ptr<Node> right;
+    };
+    typedef std::shared_ptr<Node> Link;
+    static Link merge(const Link &, const Link &);
+    static size_t rank(const Link &) noexcept;
+    Link root;
+    size_t count;
+};
+
+#include "persistent_heap.hxx"
+#endif
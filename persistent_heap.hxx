@@ -0,0 +1,203 @@
+#include <utility>
+#include <vector>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  In a leftist heap the rank, the length of the rightmost path, of a left
+ *  child is never less than that of its right sibling. Merging walks only
+ *  right spines, which are O(log(n)) long, so insert() and removeMin() copy
+ *  O(log(n)) nodes.
+ *  </p>
+ *
+ *  <p>
+ *  Left spines on the other hand can be O(n) long, e.g. after inserting in
+ *  ascending order. Letting shared_ptr free such a spine would recurse once
+ *  per node. ~Node() instead moves children it owns exclusively to an
+ *  explicit stack and frees them one at a time.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty PersistentHeap.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @tparam T type of object stored.
+ */
+template <class T>
+PersistentHeap<T>::PersistentHeap() : count(0)
+{
+}
+
+/**
+ *  @brief Returns the logical size of the PersistentHeap.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @tparam T type of object stored.
+ *  @return size_t number of entries.
+ */
+template <class T>
+size_t PersistentHeap<T>::size() const noexcept
+{
+  return count;
+}
+
+/**
+ *  @brief Returns the minimum entry. The behavior when the heap is empty is
+ *  undefined.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @tparam T type of object stored.
+ *  @return T copy of the minimum entry.
+ */
+template <class T>
+T PersistentHeap<T>::min() const
+{
+  return root->val;
+}
+
+/**
+ *  @brief Removes the minimum entry and returns it. The behavior when the
+ *  heap is empty is undefined.
+ *
+ *  The root's subtrees are merged into a new root. Snapshots sharing the old
+ *  root keep it.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size().
+ *
+ *  @tparam T type of object stored.
+ *  @return T the minimum entry.
+ */
+template <class T>
+T PersistentHeap<T>::removeMin()
+{
+  T save = root->val;
+  root = merge(root->left, root->right);
+  --count;
+  return save;
+}
+
+/**
+ *  @brief Inserts a new entry.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size().
+ *
+ *  @tparam T type of object stored.
+ *  @param val new object to be stored, will be copied.
+ */
+template <class T>
+void PersistentHeap<T>::insert(T val)
+{
+  root = merge(root, std::make_shared<Node>(val, 01, Link(), Link()));
+  ++count;
+}
+
+/**
+ *  @brief Merge two leftist heaps into a new one without modifying either.
+ *
+ *  Algorithm:
+ *  <p>
+ *    - Let a be the heap with the lesser root.
+ *    - Merge a's right subtree with b.
+ *    - Make a copy of a's root with the merged heap and a's left subtree as
+ *        children, the one of greater rank on the left.
+ *  </p>
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is the combined size.
+ *
+ *  @tparam T type of object stored.
+ *  @param a first heap, may be null.
+ *  @param b second heap, may be null.
+ *  @return the merged heap.
+ */
+template <class T>
+typename PersistentHeap<T>::Link PersistentHeap<T>::merge(const Link &a,
+  const Link &b)
+{
+  if(!a)
+  {
+    return b;
+  }
+  if(!b)
+  {
+    return a;
+  }
+  if(b->val < a->val)
+  {
+    return merge(b, a);
+  }
+  Link merged = merge(a->right, b);
+  if(rank(a->left) >= rank(merged))
+  {
+    return std::make_shared<Node>(a->val, rank(merged) + 01, a->left, merged);
+  }
+  return std::make_shared<Node>(a->val, rank(a->left) + 01, merged, a->left);
+}
+
+/**
+ *  @brief Returns the rank of a node, 0 for null.
+ *
+ *  @tparam T type of object stored.
+ *  @param n node, may be null.
+ */
+template <class T>
+size_t PersistentHeap<T>::rank(const Link &n) noexcept
+{
+  return n ? n->rank : 0;
+}
+
+/**
+ *  @brief Constructs a node.
+ *
+ *  @tparam T type of object stored.
+ *  @param val entry of the node.
+ *  @param rank length of the node's right spine.
+ *  @param left left child, may be null.
+ *  @param right right child, may be null.
+ */
+template <class T>
+PersistentHeap<T>::Node::Node(const T &val, size_t rank, const Link &left,
+  const Link &right) : val(val), rank(rank), left(left), right(right)
+{
+}
+
+/**
+ *  @brief Destructs a node, freeing descendants no other heap shares
+ *  iteratively instead of recursively.
+ *
+ *  A use count of 1 means this node holds the only reference, and with no
+ *  weak references around nobody can obtain another, so the child can be
+ *  stripped of its own children before it is released.
+ *
+ *  @tparam T type of object stored.
+ */
+template <class T>
+PersistentHeap<T>::Node::~Node()
+{
+  if((!left || left.use_count() != 01) && (!right || right.use_count() != 01))
+  {
+    return;
+  }
+  std::vector<Link> doomed;
+  doomed.push_back(std::move(left));
+  doomed.push_back(std::move(right));
+  while(!doomed.empty())
+  {
+    Link n = std::move(doomed.back());
+    doomed.pop_back();
+    if(n && n.use_count() == 01)
+    {
+      doomed.push_back(std::move(n->left));
+      doomed.push_back(std::move(n->right));
+    }
+  }
+}
@@ -0,0 +1,143 @@
+#ifndef PRIORITY_EXECUTOR_H
+#define PRIORITY_EXECUTOR_H
+#if __cplusplus < 202002L
+  #error "priority_executor.h requires C++20 coroutines"
+#endif
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "blocking_queue.h"
+#include "delay_queue.h"
+
+/**
+ *  PriorityExecutor class defines a pool of worker threads running C++20
+ *  coroutines in priority order.
+ *
+ *  <p>
+ *  The ready queue is a BlockingPriorityQueue of coroutine handles, so
+ *  scheduling work stores a handle and a priority and never allocates a
+ *  std::function. Lower priority values run first, equal priorities run in
+ *  the order they were scheduled. Workers dequeue up to a batch of handles
+ *  per lock acquisition. A larger batch lowers contention but lets a worker
+ *  finish its batch before a more urgent handle scheduled meanwhile.
+ *  </p>
+ *
+ *  <p>
+ *  A coroutine returning Task is started with spawn(). Inside it,
+ *  co_await yield(priority) requeues it at a new priority and
+ *  co_await sleepUntil(t) parks it in a DelayQueue served by a timer thread
+ *  until t. The destructor waits for every spawned Task to finish.
+ *  </p>
+ *
+ *  Member Variables:\n
+ *    ready BlockingPriorityQueue of runnable handles.
+ *    sleeping DelayQueue of handles waiting for a deadline.
+ *    sequence counter breaking priority ties in scheduling order.
+ *    batch maximum number of handles a worker dequeues at once.
+ *    live number of spawned Tasks that have not finished.
+ *    idle mutex and condition join() waits on for live to reach 0.
+ *    workers worker threads.
+ *    timer thread moving woken sleepers to ready.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) start the workers and the timer thread.
+ *    - (Destructor) join() then stop all threads.
+ *    - spawn() schedule a Task at a priority.
+ *    - yield() awaitable requeueing the caller at a priority.
+ *    - sleepUntil() awaitable resuming the caller after a deadline.
+ *    - join() block until every spawned Task has finished.
+ *    - schedule() private helper queue a handle at a priority.
+ *    - work() private helper worker thread loop.
+ *    - wakeSleepers() private helper timer thread loop.
+ *  </p>
+ */
+class PriorityExecutor
+{
+  public:
+    typedef std::chrono::steady_clock::time_point time_point;
+
+    /**
+     *  Task is the return type of coroutines run by a PriorityExecutor. It
+     *  starts suspended and owns its frame until passed to spawn(), after
+     *  which the frame frees itself when the coroutine returns.
+     */
+    class Task
+    {
+      public:
+        struct promise_type
+        {
+          PriorityExecutor *executor = nullptr;
+          Task get_return_object() noexcept;
+          std::suspend_always initial_suspend() noexcept { return {}; }
+          std::suspend_never final_suspend() noexcept { return {}; }
+          void return_void() noexcept {}
+          void unhandled_exception() noexcept;
+          ~promise_type();
+        };
+        Task(Task &&) noexcept;
+        Task(const Task &) = delete;
+        ~Task();
+
+      private:
+        friend class PriorityExecutor;
+        explicit Task(std::coroutine_handle<promise_type>) noexcept;
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    /**
+     *  Awaiter returned by yield() and sleepUntil().
+     */
+    struct Reschedule
+    {
+      PriorityExecutor &executor;
+      int priority;
+      bool timed;
+      time_point deadline;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<>);
+      void await_resume() const noexcept {}
+    };
+
+    explicit PriorityExecutor(size_t threads, size_t batch = 0x10);
+    ~PriorityExecutor();
+    void spawn(Task, int);
+    Reschedule yield(int) noexcept;
+    Reschedule sleepUntil(time_point, int = 0) noexcept;
+    void join();
+
+  private:
+    /**
+     *  Entry is a handle queued at a priority, null to stop a thread.
+     */
+    struct Entry
+    {
+      int priority;
+      unsigned long long sequence;
+      std::coroutine_handle<> handle;
+      bool operator<(const Entry &o) const
+      {
+        return priority < o.priority ||
+          (priority == o.priority && sequence < o.sequence);
+      }
+    };
+    void schedule(std::coroutine_handle<>, int);
+    void work();
+    void wakeSleepers();
+    BlockingPriorityQueue<Entry> ready;
+    DelayQueue<Entry> sleeping;
+    std::atomic<unsigned long long> sequence;
+    size_t batch;
+    std::atomic<size_t> live;
+    std::mutex idleLock;
+    std::condition_variable idle;
+    std::vector<std::thread> workers;
+    std::thread timer;
+};
+
+#include "priority_executor.hxx"
+#endif
@@ -0,0 +1,234 @@
+#include <climits>
+#include <exception>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  Threads are stopped by queueing null handles at INT_MAX priority, which
+ *  sort after all real work. The destructor only does so after join(), so no
+ *  handle is left behind in either queue.
+ *  </p>
+ *
+ *  <p>
+ *  A spawned Task is counted in live until its promise is destroyed, which
+ *  happens right after final_suspend() since that does not suspend. The last
+ *  Task to finish notifies join() under idleLock so the notification cannot
+ *  slip between join() testing live and going to sleep.
+ *  </p>
+ */
+
+/**
+ *  @brief Create the Task owning a new coroutine frame.
+ */
+inline PriorityExecutor::Task
+PriorityExecutor::Task::promise_type::get_return_object() noexcept
+{
+  return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+/**
+ *  @brief Exceptions escaping a Task have nowhere to go, so terminate.
+ */
+inline void PriorityExecutor::Task::promise_type::unhandled_exception()
+  noexcept
+{
+  std::terminate();
+}
+
+/**
+ *  @brief Count the Task as finished once its frame is destroyed.
+ */
+inline PriorityExecutor::Task::promise_type::~promise_type()
+{
+  if(executor && executor->live.fetch_sub(01) == 01)
+  {
+    std::lock_guard<std::mutex> guard(executor->idleLock);
+    executor->idle.notify_all();
+  }
+}
+
+inline PriorityExecutor::Task::Task(std::coroutine_handle<promise_type> h)
+  noexcept : handle(h)
+{
+}
+
+inline PriorityExecutor::Task::Task(Task &&o) noexcept : handle(o.handle)
+{
+  o.handle = nullptr;
+}
+
+/**
+ *  @brief Destroy the frame of a Task that was never spawned.
+ */
+inline PriorityExecutor::Task::~Task()
+{
+  if(handle)
+  {
+    handle.destroy();
+  }
+}
+
+/**
+ *  @brief Queue the suspended coroutine, on the ready queue or on the
+ *  sleeping queue when a deadline was given.
+ *
+ *  @param h the awaiting coroutine.
+ */
+inline void PriorityExecutor::Reschedule::await_suspend(
+  std::coroutine_handle<> h)
+{
+  if(timed)
+  {
+    Entry e = {priority, 0, h};
+    executor.sleeping.push(e, deadline);
+  }
+  else
+  {
+    executor.schedule(h, priority);
+  }
+}
+
+/**
+ *  @brief Start the worker and timer threads.
+ *
+ *  @param threads number of worker threads, at least 1.
+ *  @param batch maximum number of handles dequeued per lock acquisition.
+ */
+inline PriorityExecutor::PriorityExecutor(size_t threads, size_t batch) :
+  sequence(0), batch(batch ? batch : 01), live(0)
+{
+  for(size_t t = 0; t < (threads ? threads : 01); ++t)
+  {
+    workers.push_back(std::thread(&PriorityExecutor::work, this));
+  }
+  timer = std::thread(&PriorityExecutor::wakeSleepers, this);
+}
+
+/**
+ *  @brief Wait for every spawned Task, then stop and join all threads.
+ */
+inline PriorityExecutor::~PriorityExecutor()
+{
+  join();
+  Entry stop = {INT_MAX, 0, nullptr};
+  sleeping.push(stop, time_point());
+  timer.join();
+  for(size_t t = 0; t < workers.size(); ++t)
+  {
+    ready.push(stop);
+  }
+  for(size_t t = 0; t < workers.size(); ++t)
+  {
+    workers[t].join();
+  }
+}
+
+/**
+ *  @brief Schedule a Task to start at a priority.
+ *
+ *  The executor takes ownership of the coroutine frame.
+ *
+ *  @param task coroutine to run.
+ *  @param priority lower values run first.
+ */
+inline void PriorityExecutor::spawn(Task task, int priority)
+{
+  std::coroutine_handle<Task::promise_type> h = task.handle;
+  task.handle = nullptr;
+  h.promise().executor = this;
+  live.fetch_add(01);
+  schedule(h, priority);
+}
+
+/**
+ *  @brief Returns an awaitable that requeues the caller at a priority.
+ *
+ *  @param priority lower values run first.
+ */
+inline PriorityExecutor::Reschedule PriorityExecutor::yield(int priority)
+  noexcept
+{
+  return Reschedule{*this, priority, false, time_point()};
+}
+
+/**
+ *  @brief Returns an awaitable that resumes the caller at a priority once a
+ *  deadline has passed.
+ *
+ *  @param at steady_clock deadline.
+ *  @param priority lower values run first once the deadline has passed.
+ */
+inline PriorityExecutor::Reschedule PriorityExecutor::sleepUntil(
+  time_point at, int priority) noexcept
+{
+  return Reschedule{*this, priority, true, at};
+}
+
+/**
+ *  @brief Block until every spawned Task has finished.
+ */
+inline void PriorityExecutor::join()
+{
+  std::unique_lock<std::mutex> guard(idleLock);
+  while(live.load() != 0)
+  {
+    idle.wait(guard);
+  }
+}
+
+/**
+ *  @brief Queue a handle on the ready queue.
+ *
+ *  @param h coroutine to resume.
+ *  @param priority lower values run first.
+ */
+inline void PriorityExecutor::schedule(std::coroutine_handle<> h,
+  int priority)
+{
+  Entry e = {priority, sequence.fetch_add(01, std::memory_order_relaxed), h};
+  ready.push(e);
+}
+
+/**
+ *  @brief Worker loop: resume batches of handles until a stop entry.
+ */
+inline void PriorityExecutor::work()
+{
+  std::vector<Entry> taken;
+  taken.reserve(batch);
+  for(;;)
+  {
+    taken.clear();
+    ready.popN(taken, batch);
+    for(size_t i = 0; i < taken.size(); ++i)
+    {
+      if(!taken[i].handle)
+      {
+        //put back the rest of the batch for the remaining workers
+        for(size_t j = i + 01; j < taken.size(); ++j)
+        {
+          ready.push(taken[j]);
+        }
+        return;
+      }
+      taken[i].handle.resume();
+    }
+  }
+}
+
+/**
+ *  @brief Timer loop: move sleepers whose deadline passed to the ready
+ *  queue until a stop entry.
+ */
+inline void PriorityExecutor::wakeSleepers()
+{
+  for(;;)
+  {
+    Entry e = sleeping.take();
+    if(!e.handle)
+    {
+      return;
+    }
+    schedule(e.handle, e.priority);
+  }
+}
@@ -1,11 +1,85 @@
 #ifndef PRIORITY_QUEUE_H
 #define PRIORITY_QUEUE_H
 #include <vector>
+#include <cstddef>
 
 #ifndef TEST
   #define TEST
 #endif
 
+/**
+ *  PriorityQueueTuning describes the shape of the heap used by a
+ *  PriorityQueue whose entries are a given number of bytes wide.
+ *
+ *  <p>
+ *  The primary template is a conservative default: a binary heap without
+ *  software prefetching. Host specific values are produced by the calibrate
+ *  utility, which writes a header of specializations of this template. Define
+ *  PRIORITY_QUEUE_TUNING to the quoted name of that header to pick them up,
+ *  e.g. -DPRIORITY_QUEUE_TUNING='"tuning_zen.h"'.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    Size sizeof() the entries stored in the PriorityQueue().
+ *
+ *  Member Variables:\n
+ *    arity number of children each heap node has, at least 2.
+ *    prefetch how many levels below the current node removeMin() prefetches,
+ *      0 disables prefetching.
+ */
+template <size_t Size>
+struct PriorityQueueTuning
+{
+  static const size_t arity = 02;
+  static const size_t prefetch = 0;
+};
+
+#ifdef PRIORITY_QUEUE_TUNING
+  #include PRIORITY_QUEUE_TUNING
+#endif
+
+/**
+ *  Identity is the default projection of a PriorityQueue: entries are
+ *  compared as they are.
+ */
+template <class T>
+struct Identity
+{
+  const T &operator()(const T &val) const noexcept { return val; }
+};
+
+/**
+ *  MemberKey is a projection to a data member, e.g. the deadline of a job.
+ *
+ *  <p>
+ *  C++11 has no non-type template parameters of deduced type, so the member
+ *  pointer is held at run time. memberKey() deduces the types:
+ *  PriorityQueue<Job, MemberKey<Job, double> > q(memberKey(&Job::deadline)).
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    C class holding the member.
+ *    K type of the member.
+ */
+template <class C, class K>
+struct MemberKey
+{
+  K C::*member;
+  const K &operator()(const C &val) const noexcept { return val.*member; }
+};
+
+/**
+ *  @brief Make a MemberKey projecting to a given data member.
+ *
+ *  @param member pointer to the data member.
+ */
+template <class C, class K>
+MemberKey<C, K> memberKey(K C::*member) noexcept
+{
+  MemberKey<C, K> key = {member};
+  return key;
+}
+
 /**
  *  PriorityQueue class defines a min-heap that is useful for maintaining a
  *  sorted collection of entries and allowing for quick access to the smallest
@@ -15,54 +89,80 @@
  *  Entries are stored in contiguous memory and internal resizing may occur as
  *  new entries are inserted. As new items are inserted, old items are shuffled
  *  around to maintain the heap property of the internal data structure.
- *  Comparisons are made using the less-than, <, operator. In the future, this
- *  can be generalized by a template parameter.
+ *  Comparisons are made using the less-than, <, operator on a projection of
+ *  the entries, the entries themselves by default. A projection such as a
+ *  MemberKey or a lambda orders entries by one of their fields without
+ *  writing an operator< for them.
  *  </p>
  *
  *  Template Parameters:\n
  *    T Type of the entries stored in the PriorityQueue().
+ *    Key projection applied to entries before comparing them, defaults to
+ *      Identity.
+ *    Tuning PriorityQueueTuning-like type giving the arity and prefetch
+ *      distance of the heap, defaults to the tuning for sizeof(T).
+ *    Storage random access container of T holding the heap, with size(),
+ *      operator[], push_back() and pop_back(), defaults to std::vector.
  *
  *  Member Variables:\n
- *    heap std::vector maintaining internal storage of entries.
+ *    heap Storage maintaining internal storage of entries.
+ *    key projection of entries compared by the heap.
+ *    arity number of children per node, taken from Tuning.
  *    TEST macro used for tests to access to private member variables.
  *
  *  Member Functions:
  *  <p>
- *    - (Constructor) public constructor.
+ *    - (Constructor) public constructor, optionally taking the projection,
+ *        or adopting a Storage that already holds a heap.
  *    - (Destructor) public destructor.
  *    - size() return logical size.
  *    - min() return the minimum entry.
  *    - removeMin() remove the minimum entry and return it.
  *    - insert() insert a new entry.
+ *    - removeIf() remove every entry matching a predicate.
  *    - parent() private helper return the parent location given a position.
- *    - leftChild() private helper return left child location given a position.
- *    - rightChild() private helper return right child location given a
+ *    - firstChild() private helper return first child location given a
  *        position.
- *    - leftInBounds() private helper return whether left child is inbounds.
- *    - rightInBounds() private helper return whether right child is inbounds.
- *    - minChild() private helper return the lesser child of a given position.
+ *    - lastChild() private helper return last child location given a
+ *        position, which may be out of bounds.
+ *    - minChild() private helper return the least child of a given position.
+ *    - siftDown() private helper move an entry down until it is no greater
+ *        than its children.
+ *    - at() private helper return a read-only reference to an entry.
+ *    - less() private helper compare two entries by their keys.
+ *    - prefetch() private helper prefetch the descendants of a position.
  *  </p>
  */
-template <class T>
+template <class T, class Key = Identity<T>,
+  class Tuning = PriorityQueueTuning<sizeof(T)>,
+  class Storage = std::vector<T> >
 class PriorityQueue
 {
   public:
-    PriorityQueue();
+    explicit PriorityQueue(const Key & = Key());
+    PriorityQueue(const Key &, const Storage &);
     ~PriorityQueue();
     size_t size() const noexcept;
     T min() const;
     T removeMin();
     void insert(T);
+    template <class Predicate>
+    size_t removeIf(Predicate);
 
   private:
+    static const size_t arity = Tuning::arity;
+    static_assert(Tuning::arity >= 02, "a heap needs at least two children");
     inline void swap(size_t, size_t);
     static inline size_t parent(size_t) noexcept;
-    static inline size_t leftChild(size_t) noexcept;
-    static inline size_t rightChild(size_t) noexcept;
-    inline bool leftInBounds(size_t) const noexcept;
-    inline bool rightInBounds(size_t) const noexcept;
-    size_t minChild(size_t);
-    std::vector<T> heap;
+    static inline size_t firstChild(size_t) noexcept;
+    static inline size_t lastChild(size_t) noexcept;
+    size_t minChild(size_t) const;
+    void siftDown(size_t);
+    inline const T &at(size_t) const noexcept;
+    inline bool less(const T &, const T &) const;
+    inline void prefetch(size_t) const noexcept;
+    Storage heap;
+    Key key;
     TEST;
 };
 
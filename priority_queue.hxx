@@ -7,27 +7,75 @@
  *  is 1-based rather than zero-based unlike most c arrays. This is done so
  *  that all parent/child relationships can be generalized without having
  *  special cases for entries at position zero. The parent-child relationship
- *  works as follows: Suppose a parent is located at position n, its left child
- *  is location at position 2n, and its right child is located at 2n+1. To
- *  implement this, a meaningless entry is placed at position zero in the heap.
+ *  works as follows: Suppose a parent is located at position n in a heap of
+ *  arity d, its children are located at positions d(n-1)+2 through dn+1. For
+ *  the binary heap this is the familiar 2n and 2n+1. To implement this, a
+ *  meaningless entry is placed at position zero in the heap.
  *  Entries are inserted into the heap is a level-order manner, this is why
  *  the parent and child relationships are how they are, because new children
  *  are simply appended to the array.
  *  </p>
+ *
+ *  <p>
+ *  Siblings are adjacent in the array, so a wider heap trades more
+ *  comparisons per level in removeMin() for fewer levels and fewer cache
+ *  misses. Which arity wins depends on the entry size and the host, see
+ *  PriorityQueueTuning.
+ *  </p>
+ *
+ *  <p>
+ *  The array itself is a Storage, std::vector by default. Entries are only
+ *  read through at() and only written through swap(), insert() and
+ *  removeMin(), which lets ChunkedStorage share unmodified parts of the
+ *  array between copies of a PriorityQueue.
+ *  </p>
  */
 
 /**
  *  @brief Constructs an empty PriorityQueue.
  *
  *  Initialize the internal heap to have an initial capacity of 1.
+ *  The projection is copied, which allows lambdas and other functors that
+ *  are not default constructible.
  *
  *  Complexity:\n
  *    Constant
  *
  *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
+ *  @param key projection of entries compared by the heap.
+ */
+template <class T, class Key, class Tuning, class Storage>
+PriorityQueue<T, Key, Tuning, Storage>::PriorityQueue(const Key &key) :
+  heap(01), key(key)
+{
+}
+
+/**
+ *  @brief Constructs a PriorityQueue over a Storage that already holds a
+ *  heap.
+ *
+ *  The storage is adopted as it is: position 0 is the filler and the
+ *  entries after it must be in heap order, e.g. an empty storage of size 1.
+ *  This lets a Storage that is a view of memory owned elsewhere, such as a
+ *  shared memory segment, be attached to by several PriorityQueues in turn.
+ *
+ *  Complexity:\n
+ *    The cost of copying the storage.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
+ *  @param key projection of entries compared by the heap.
+ *  @param storage the heap, with its filler entry.
  */
-template <class T>
-PriorityQueue<T>::PriorityQueue() : heap(01)
+template <class T, class Key, class Tuning, class Storage>
+PriorityQueue<T, Key, Tuning, Storage>::PriorityQueue(const Key &key,
+  const Storage &storage) :
+  heap(storage), key(key)
 {
 }
 
@@ -39,9 +87,12 @@ PriorityQueue<T>::PriorityQueue() : heap(01)
  *    the type parameter also needs to be destructed.
  * 
  *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
  */
-template <class T>
-PriorityQueue<T>::~PriorityQueue()
+template <class T, class Key, class Tuning, class Storage>
+PriorityQueue<T, Key, Tuning, Storage>::~PriorityQueue()
 {
 }
 
@@ -63,10 +114,13 @@ PriorityQueue<T>::~PriorityQueue()
  *    Constant
  *
  *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
  *  @return size_t size of PriorityQueue.
  */
-template <class T>
-size_t PriorityQueue<T>::size() const noexcept
+template <class T, class Key, class Tuning, class Storage>
+size_t PriorityQueue<T, Key, Tuning, Storage>::size() const noexcept
 {
   return (heap.size() - 01);
 }
@@ -81,12 +135,15 @@ size_t PriorityQueue<T>::size() const noexcept
  *    Constant time
  * 
  *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
  *  @return T copy of the minimum entry in the PriorityQueue.
  */
-template <class T>
-T PriorityQueue<T>::min() const
+template <class T, class Key, class Tuning, class Storage>
+T PriorityQueue<T, Key, Tuning, Storage>::min() const
 {
-  return heap[01];
+  return at(01);
 }
 
 /**
@@ -102,35 +159,28 @@ T PriorityQueue<T>::min() const
  *    - Put the last entry into the root of the heap.
  *    - Bubble it down the heap until it satisfies the heap-order property.
  *    - If, while bubbling down, the entry of interest has a value greater than
- *        that of <em>both</em> of its children: swap with the lesser of the
- *        two.
+ *        that of <em>any</em> of its children: swap with the least of them.
  *  </p>
  *
  *  Implementation notes:\n
- *    Always swap the bubbled entry with the lesser of the two children.
- *    Refer to the bubbled entry by its index i within the vector.
+ *    The bubbling is done by siftDown(), shared with removeIf().
  *
  *  Complexity:\n
- *    O(log(n)) where n is PriorityQueue::size()
+ *    O(d log(n)/log(d)) where n is PriorityQueue::size() and d is the arity.
  * 
  *  @tparam T type of the object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
  *  @return T object stored at the minimum entry in the PriorityQueue.
  */
-template <class T>
-T PriorityQueue<T>::removeMin()
+template <class T, class Key, class Tuning, class Storage>
+T PriorityQueue<T, Key, Tuning, Storage>::removeMin()
 {
-  T save = heap[1]; //save the min entry for returning
-  heap[1] = heap.back();
+  T save = at(01); //save the min entry for returning
+  heap[01] = at(size());
   heap.pop_back(); //swap the first and last items
-
-  size_t i = 1;
-  size_t swaper;
-
-  while(heap[(swaper = minChild(i))] < heap[i])
-  {
-    swap(i, swaper);
-    i = swaper;
-  }
+  siftDown(01);
   return save;
 }
 
@@ -158,20 +208,79 @@ T PriorityQueue<T>::removeMin()
  *    In the worst case, this takes O(n) when the heap needs to resize.
  * 
  *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
  *  @param val new object to be stored, will be copied.
  */
-template <class T>
-void PriorityQueue<T>::insert(T val)
+template <class T, class Key, class Tuning, class Storage>
+void PriorityQueue<T, Key, Tuning, Storage>::insert(T val)
 {
   heap.push_back(val);
   size_t entryNo = size(); //location the new entry is at
-  while(entryNo > 01 && val < heap[parent(entryNo)])
+  while(entryNo > 01 && less(val, at(parent(entryNo))))
   {
     swap(entryNo, parent(entryNo)); //swap entry and its parent
     entryNo = parent(entryNo);
   }
 }
 
+/**
+ *  @brief Removes every entry for which a predicate holds.
+ *
+ *  Meant for bulk pruning, such as dropping every open node whose bound is
+ *  no better than a new incumbent, where removing entries one at a time is
+ *  not possible since only the minimum is reachable.
+ *
+ *  Algorithm:
+ *  <p>
+ *    - Visit the entries in heap order, i.e. by position, sliding the kept
+ *        ones towards the front.
+ *    - Drop the tail left over.
+ *    - If anything was removed, restore heap order bottom up, sifting down
+ *        every entry that has children, last first.
+ *  </p>
+ *
+ *  Complexity:\n
+ *    O(n) where n is PriorityQueue::size(), plus n calls of the predicate.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
+ *  @tparam Predicate callable taking a const T & and returning whether to
+ *    remove it, called once per entry in position order.
+ *  @param pred the predicate.
+ *
+ *  @return the number of entries removed.
+ */
+template <class T, class Key, class Tuning, class Storage>
+template <class Predicate>
+size_t PriorityQueue<T, Key, Tuning, Storage>::removeIf(Predicate pred)
+{
+  size_t n = size();
+  size_t kept = 0;
+  for(size_t i = 01; i <= n; ++i)
+  {
+    if(!pred(at(i)) && ++kept != i)
+    {
+      heap[kept] = at(i);
+    }
+  }
+  for(size_t i = kept; i < n; ++i)
+  {
+    heap.pop_back();
+  }
+  if(kept != n)
+  {
+    for(size_t i = parent(kept); i >= 01; --i)
+    {
+      siftDown(i);
+    }
+  }
+  return n - kept;
+}
+
 /**
  *  @brief Given two indices swap them in the heap.
  *
@@ -184,140 +293,258 @@ void PriorityQueue<T>::insert(T val)
  *    O(1) for the swap, but proportional to the time to copy T.
  * 
  *  @tparam T type of the object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
  *  @param a first index to swap.
  *  @param b second index to swap.
  */
-template <class T>
-void PriorityQueue<T>::swap(size_t a, size_t b)
+template <class T, class Key, class Tuning, class Storage>
+void PriorityQueue<T, Key, Tuning, Storage>::swap(size_t a, size_t b)
 {
   std::swap(heap[a], heap[b]);
 }
 
+/**
+ *  @brief Given an index returns a read-only reference to its entry.
+ *
+ *  All comparisons read entries through this helper rather than through
+ *  the non-const operator[] of the Storage, so that a copy-on-write Storage
+ *  only unshares memory that is actually written.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @tparam T type of the object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
+ *  @param loc index of the entry.
+ *
+ *  @return const reference to the entry at loc.
+ */
+template <class T, class Key, class Tuning, class Storage>
+inline const T &PriorityQueue<T, Key, Tuning, Storage>::at(size_t loc) const
+  noexcept
+{
+  return heap[loc];
+}
+
+/**
+ *  @brief Compares two entries by their projected keys.
+ *
+ *  Every comparison made by the heap goes through this helper, so the key
+ *  is projected once per entry per comparison. When that is expensive, use
+ *  KeyCachingQueue, which projects each entry once on insert.
+ *
+ *  @tparam T type of the object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
+ *  @param a first entry.
+ *  @param b second entry.
+ *
+ *  @return whether the key of a is less than the key of b.
+ */
+template <class T, class Key, class Tuning, class Storage>
+inline bool PriorityQueue<T, Key, Tuning, Storage>::less(const T &a,
+  const T &b) const
+{
+  return key(a) < key(b);
+}
+
 /**
  *  @brief Given a location will return the parent location.
  *
  *  The internal heap is maintained in contiguous memory, if an entry resides
- *  at a location n, its parent resides at location n/2.
+ *  at a location n, its parent resides at location (n+d-2)/d. For the binary
+ *  heap this is n/2.
  *
  *  Algorithm:
- *    Right shift operator is used for preformance to divide by two.
+ *    arity is a compile time constant so the division becomes a shift for
+ *    powers of two.
  *
  *  Complexity:\n
  *    Constant.
  * 
  *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
  *  @param loc the location that you want the parent of.
  * 
- *  @return the parent location of the given location.
+ *  @return the parent location of the given location, 0 for the root.
  */
-template <class T>
-inline size_t PriorityQueue<T>::parent(size_t loc) noexcept
+template <class T, class Key, class Tuning, class Storage>
+inline size_t PriorityQueue<T, Key, Tuning, Storage>::parent(
+  size_t loc) noexcept
 {
-  return (loc>>01);
+  return ((loc + arity - 02) / arity);
 }
 
 /**
- *  @brief Given a location will return the leftChild location.
+ *  @brief Given a location will return the first child location.
  *
  *  The internal heap is maintained in contiguous memory, if an entry resides
- *  at a location n, its leftChild resides at location n*2.
- *
- *  Algorithm:
- *    Left shift operator is used for preformance to multiply by two.
+ *  at a location n, its first child resides at location d(n-1)+2.
  *
  *  Complexity:\n
  *    Constant.
  * 
  *  @tparam T type of object stored.
- *  @param loc the array index to return the parent of.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
+ *  @param loc the location that you want the first child of.
  * 
- *  @return the parent location of the given location.
+ *  @return the first child location of the given location.
  */
-template <class T>
-inline size_t PriorityQueue<T>::leftChild(size_t loc) noexcept
+template <class T, class Key, class Tuning, class Storage>
+inline size_t PriorityQueue<T, Key, Tuning, Storage>::firstChild(
+  size_t loc) noexcept
 {
-  return (loc<<01);
+  return (arity * (loc - 01) + 02);
 }
 
 /**
- *  @brief Given a location will return the rightChild location.
+ *  @brief Given a location will return the last child location.
  *
  *  The internal heap is maintained in contiguous memory, if an entry resides
- *  at a location n, its rightChild resides at location n*2 + 1.
- *
- *  Algorithm:
- *    Left shift operator is used for preformance to multiply by two.
+ *  at a location n, its last child resides at location dn+1. The returned
+ *  location may be past the end of the heap.
  *
  *  Complexity:\n
  *    Constant.
  * 
  *  @tparam T type of object stored.
- *  @param loc the location that you want the parent of.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
+ *  @param loc the location that you want the last child of.
  * 
- *  @return the parent location of the given location.
+ *  @return the last child location of the given location.
  */
-template <class T>
-inline size_t PriorityQueue<T>::rightChild(size_t loc) noexcept
+template <class T, class Key, class Tuning, class Storage>
+inline size_t PriorityQueue<T, Key, Tuning, Storage>::lastChild(
+  size_t loc) noexcept
 {
-  return ((loc<<01) + 01);
+  return (arity * loc + 01);
 }
 
 /**
- *  @brief Determines if the leftChild of the given location is within bounds
- *  of the PriorityQueue internal heap.
- * 
+ *  @brief Given an index into the heap returns the index of the semantically
+ *  least child entry.
+ *
+ *  Children past the end of the heap are ignored. If no child is in bounds,
+ *  then pos is returned.
+ *
  *  @tparam T type of the object stored.
- *  @param loc int representing the location to test.
- * 
- *  @return whether the leftChild of the given location is a valid heap index.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
+ *  @param pos the heap position to return the minimum child of.
+ *
+ *  @return the least child or pos if every child is out of bounds.
  */
-template <class T>
-inline bool PriorityQueue<T>::leftInBounds(size_t loc) const noexcept
+template <class T, class Key, class Tuning, class Storage>
+size_t PriorityQueue<T, Key, Tuning, Storage>::minChild(size_t pos) const
 {
-  return (leftChild(loc) <= size());
+  size_t least = firstChild(pos);
+  if(least > size())
+  {
+    return pos;
+  }
+  size_t last = lastChild(pos) <= size() ? lastChild(pos) : size();
+  for(size_t c = least + 01; c <= last; ++c)
+  {
+    if(less(at(c), at(least)))
+    {
+      least = c;
+    }
+  }
+  return least;
 }
 
 /**
- *  @brief Determines if the rightChild of the given location is within bounds
- *  of the PriorityQueue internal heap.
- * 
+ *  @brief Moves the entry at a position down, always swapping with the
+ *  least child, until no child is less than it.
+ *
+ *  When Tuning::prefetch is non-zero, the descendants of the entry that
+ *  many levels down are prefetched before comparing its children.
+ *
+ *  Complexity:\n
+ *    O(d log(n)/log(d)) where n is PriorityQueue::size() and d is the arity.
+ *
  *  @tparam T type of the object stored.
- *  @param loc int representing the location to test.
- * 
- *  @return whether the rightChild of the given location is a valid heap index.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
+ *  @param i the heap position to sift down from.
  */
-template <class T>
-inline bool PriorityQueue<T>::rightInBounds(size_t loc) const noexcept
+template <class T, class Key, class Tuning, class Storage>
+void PriorityQueue<T, Key, Tuning, Storage>::siftDown(size_t i)
 {
-  return (rightChild(loc) <= size());
+  size_t swaper;
+
+  prefetch(i);
+  while((swaper = minChild(i)) != i && less(at(swaper), at(i)))
+  {
+    prefetch(swaper);
+    swap(i, swaper);
+    i = swaper;
+  }
 }
 
 /**
- *  @brief Given an index into the heap returns the index of the semantically
- *  lesser child entry.
+ *  @brief Prefetch the descendants of a location Tuning::prefetch levels
+ *  below it.
  *
- *  If one of the two indicies is out of bounds in the heap, then the in bounds
- *  index is returned.
- *
- *  If neither indicies are in bounds, then size() is returned.
+ *  The descendants of a location at any fixed depth are contiguous, so the
+ *  cache lines covering them are requested with one prefetch each. Compiles
+ *  to nothing when Tuning::prefetch is 0 or the compiler has no prefetch
+ *  builtin.
  *
  *  @tparam T type of the object stored.
- *  @param pos the heap position to return the minimum child of.
- *
- *  @return the least entry or pos if both l and r are out of bounds.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @tparam Storage random access container holding the heap.
+ *  @param loc the location whose descendants to prefetch.
  */
-template <class T>
-size_t PriorityQueue<T>::minChild(size_t pos)
+template <class T, class Key, class Tuning, class Storage>
+inline void PriorityQueue<T, Key, Tuning, Storage>::prefetch(
+  size_t loc) const noexcept
 {
-  bool lInBounds = leftInBounds(pos);
-  if(lInBounds && rightInBounds(pos))
+#ifdef __GNUC__
+  if(Tuning::prefetch == 0)
+  {
+    return;
+  }
+  size_t first = loc;
+  size_t last = loc;
+  for(size_t level = 0; level < Tuning::prefetch; ++level)
+  {
+    first = firstChild(first);
+    last = lastChild(last);
+  }
+  if(first > size())
+  {
+    return;
+  }
+  last = last <= size() ? last : size();
+  const char *line = reinterpret_cast<const char *>(&at(first));
+  const char *end = reinterpret_cast<const char *>(&at(last) + 01);
+  if(end != reinterpret_cast<const char *>(&at(first) + (last - first + 01)))
   {
-    return (heap[leftChild(pos)] < heap[rightChild(pos)]) ?
-      leftChild(pos) : rightChild(pos);
+    //the descendants straddle chunks of a non-contiguous Storage
+    __builtin_prefetch(line);
+    __builtin_prefetch(&at(last));
+    return;
   }
-  else if(lInBounds)
+  for(; line < end; line += 0x40) //64 byte cache lines
   {
-    return leftChild(pos);
+    __builtin_prefetch(line);
   }
-  return pos;
+#else
+  (void)loc;
+#endif
 }
@@ -0,0 +1,135 @@
+#ifndef SHARDED_QUEUE_H
+#define SHARDED_QUEUE_H
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "priority_queue.h"
+
+/**
+ *  NumaTopology describes the NUMA nodes of the host as reported by sysfs.
+ *
+ *  <p>
+ *  Nodes are read from the online list under the given sysfs directory,
+ *  normally /sys/devices/system/node, along with each node's cpulist and
+ *  distance row. Any other directory laid out the same way may be given,
+ *  which is how tests describe a multi-node machine. When the directory is
+ *  missing or unreadable the host is described as a single node owning every
+ *  cpu, so callers never need a special case for non-NUMA machines.
+ *  </p>
+ *
+ *  Member Variables:\n
+ *    cpus cpu numbers of each node, indexed by dense node index.
+ *    ids the sysfs node number of each dense node index.
+ *    distance distance row of each node, indexed by dense node index.
+ *    cpuNode node index of each cpu number, 0 for cpus no node lists.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) read the topology under a sysfs directory.
+ *    - nodes() return the number of nodes.
+ *    - id() return the sysfs node number of a node index.
+ *    - cpusOf() return the cpus of a node index.
+ *    - nodeOf() return the node index of a cpu.
+ *    - currentNode() return the node index of the calling thread's cpu.
+ *    - byDistance() return every node index ordered nearest first.
+ *    - parseList() private helper parse a sysfs list such as "0-3,8".
+ *    - readFile() private helper read a whole sysfs file.
+ *  </p>
+ */
+class NumaTopology
+{
+  public:
+    explicit NumaTopology(const std::string &root = "/sys/devices/system/node");
+    size_t nodes() const noexcept;
+    unsigned id(size_t) const;
+    const std::vector<unsigned> &cpusOf(size_t) const;
+    size_t nodeOf(unsigned) const noexcept;
+    size_t currentNode() const noexcept;
+    std::vector<size_t> byDistance(size_t) const;
+
+  private:
+    static std::vector<unsigned> parseList(const std::string &);
+    static bool readFile(const std::string &, std::string &);
+    std::vector<std::vector<unsigned> > cpus;
+    std::vector<unsigned> ids;
+    std::vector<std::vector<unsigned> > distance;
+    std::vector<size_t> cpuNode;
+};
+
+/**
+ *  ShardedQueue class defines a relaxed min-heap split into one PriorityQueue
+ *  per NUMA node, so threads on different sockets do not bounce the same
+ *  cache lines over the interconnect.
+ *
+ *  <p>
+ *  Threads insert into and remove from the shard of the node they run on.
+ *  When that shard is empty removal steals from the other shards, nearest
+ *  node first. The minimum returned is therefore the minimum of one shard,
+ *  not of the whole queue.
+ *  </p>
+ *
+ *  <p>
+ *  Memory is placed by first touch. Each shard is constructed by a thread
+ *  bound to its node, and entries are only inserted by threads on that node,
+ *  so the heap storage is allocated and first written locally as it grows.
+ *  On a single node host this degrades to one mutex protected PriorityQueue.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the ShardedQueue().
+ *    Tuning arity and prefetch distance of each shard's heap.
+ *
+ *  Member Variables:\n
+ *    topology the nodes shards are assigned to.
+ *    shards one Shard per node.
+ *    steal per node the other nodes, nearest first.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) build one shard per node of a NumaTopology.
+ *    - shardCount() return the number of shards.
+ *    - size() return the total number of entries, approximate under
+ *        concurrent modification.
+ *    - insert() insert into the shard of the current or a given node.
+ *    - tryRemoveMin() remove the minimum of the local shard, stealing when it
+ *        is empty.
+ *    - tryRemoveLocal() private helper remove from one shard only.
+ *    - bindToNode() private helper bind the calling thread to a node's cpus.
+ *  </p>
+ */
+template <class T, class Tuning = PriorityQueueTuning<sizeof(T)> >
+class ShardedQueue
+{
+  public:
+    explicit ShardedQueue(const NumaTopology & = NumaTopology());
+    size_t shardCount() const noexcept;
+    size_t size() const noexcept;
+    void insert(T);
+    void insert(T, size_t);
+    bool tryRemoveMin(T &);
+    bool tryRemoveMin(T &, size_t);
+
+  private:
+    /**
+     *  Shard is a PriorityQueue with its lock and an entry count readable
+     *  without the lock, padded so neighbouring shards share no cache line.
+     */
+    struct Shard
+    {
+      char front[0x40];
+      std::mutex lock;
+      std::atomic<size_t> count;
+      PriorityQueue<T, Identity<T>, Tuning> queue;
+      char back[0x40];
+    };
+    bool tryRemoveLocal(T &, size_t);
+    static void bindToNode(const std::vector<unsigned> &);
+    NumaTopology topology;
+    std::vector<std::unique_ptr<Shard> > shards;
+    std::vector<std::vector<size_t> > steal;
+};
+
+#include "sharded_queue.hxx"
+#endif
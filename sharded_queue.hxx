@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <sched.h>
+#include <unistd.h>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  Node numbers in sysfs may be sparse, e.g. "0,2" after a node is offlined,
+ *  so nodes are referred to by a dense index into the online list everywhere.
+ *  id() maps back to the sysfs number. The distance file of a node has one
+ *  column per online node, so it is indexed by the dense index too.
+ *  </p>
+ *
+ *  <p>
+ *  Every shard keeps an atomic count of its entries, updated while holding
+ *  the shard lock. Stealing threads read it without the lock to skip empty
+ *  shards, so an idle consumer polling for work only reads remote cache lines
+ *  instead of writing them.
+ *  </p>
+ */
+
+/**
+ *  @brief Read the NUMA topology under a sysfs node directory.
+ *
+ *  Falls back to a single node holding every configured cpu when the online
+ *  list cannot be read. Missing cpulist or distance files of individual nodes
+ *  leave them empty.
+ *
+ *  @param root directory laid out like /sys/devices/system/node.
+ */
+inline NumaTopology::NumaTopology(const std::string &root)
+{
+  std::string text;
+  if(readFile(root + "/online", text))
+  {
+    ids = parseList(text);
+  }
+  for(size_t n = 0; n < ids.size(); ++n)
+  {
+    std::ostringstream dir;
+    dir << root << "/node" << ids[n];
+    cpus.push_back(readFile(dir.str() + "/cpulist", text) ?
+      parseList(text) : std::vector<unsigned>());
+
+    std::vector<unsigned> row;
+    if(readFile(dir.str() + "/distance", text))
+    {
+      std::istringstream in(text);
+      unsigned d;
+      while(in >> d)
+      {
+        row.push_back(d);
+      }
+    }
+    distance.push_back(row);
+  }
+
+  if(ids.empty())
+  {
+    long conf = sysconf(_SC_NPROCESSORS_CONF);
+    ids.assign(01, 0);
+    cpus.assign(01, std::vector<unsigned>());
+    for(long c = 0; c < (conf > 0 ? conf : 01); ++c)
+    {
+      cpus[0].push_back(static_cast<unsigned>(c));
+    }
+    distance.assign(01, std::vector<unsigned>());
+  }
+
+  //nodeOf() runs on every insert and removal, so resolve cpus once here
+  for(size_t n = 0; n < cpus.size(); ++n)
+  {
+    for(size_t c = 0; c < cpus[n].size(); ++c)
+    {
+      if(cpus[n][c] >= cpuNode.size())
+      {
+        cpuNode.resize(cpus[n][c] + 01, 0);
+      }
+      cpuNode[cpus[n][c]] = n;
+    }
+  }
+}
+
+/**
+ *  @brief Returns the number of nodes, at least 1.
+ *
+ *  Complexity:\n
+ *    Constant.
+ */
+inline size_t NumaTopology::nodes() const noexcept
+{
+  return ids.size();
+}
+
+/**
+ *  @brief Returns the sysfs node number of a node index.
+ *
+ *  @param node dense node index.
+ */
+inline unsigned NumaTopology::id(size_t node) const
+{
+  return ids[node];
+}
+
+/**
+ *  @brief Returns the cpus belonging to a node index.
+ *
+ *  @param node dense node index.
+ */
+inline const std::vector<unsigned> &NumaTopology::cpusOf(size_t node) const
+{
+  return cpus[node];
+}
+
+/**
+ *  @brief Returns the node index a cpu belongs to.
+ *
+ *  Complexity:\n
+ *    Constant.
+ *
+ *  @param cpu cpu number as returned by sched_getcpu().
+ *  @return node index, 0 for cpus not listed by any node.
+ */
+inline size_t NumaTopology::nodeOf(unsigned cpu) const noexcept
+{
+  return cpu < cpuNode.size() ? cpuNode[cpu] : 0;
+}
+
+/**
+ *  @brief Returns the node index of the cpu the calling thread runs on.
+ *
+ *  The thread may migrate right after, so this is a placement hint only.
+ */
+inline size_t NumaTopology::currentNode() const noexcept
+{
+  if(nodes() == 01)
+  {
+    return 0;
+  }
+  int cpu = sched_getcpu();
+  return cpu < 0 ? 0 : nodeOf(static_cast<unsigned>(cpu));
+}
+
+/**
+ *  @brief Returns every node index ordered by distance from a node.
+ *
+ *  The node itself always comes first. Nodes without distance information
+ *  keep their sysfs order.
+ *
+ *  @param node dense node index to measure from.
+ *  @return node indices, nearest first.
+ */
+inline std::vector<size_t> NumaTopology::byDistance(size_t node) const
+{
+  std::vector<size_t> order;
+  order.push_back(node);
+  for(size_t n = 0; n < nodes(); ++n)
+  {
+    if(n != node)
+    {
+      order.push_back(n);
+    }
+  }
+  const std::vector<unsigned> &row = distance[node];
+  std::stable_sort(order.begin() + 01, order.end(),
+    [&row](size_t a, size_t b)
+    {
+      unsigned da = a < row.size() ? row[a] : ~0u;
+      unsigned db = b < row.size() ? row[b] : ~0u;
+      return da < db;
+    });
+  return order;
+}
+
+/**
+ *  @brief Parse a sysfs list of ranges such as "0-3,8,10-11".
+ *
+ *  @param text contents of the sysfs file.
+ *  @return every number in the list, in order.
+ */
+inline std::vector<unsigned> NumaTopology::parseList(const std::string &text)
+{
+  std::vector<unsigned> out;
+  std::istringstream in(text);
+  std::string range;
+  while(std::getline(in, range, ','))
+  {
+    unsigned lo, hi;
+    char dash;
+    std::istringstream r(range);
+    if(!(r >> lo))
+    {
+      continue;
+    }
+    hi = (r >> dash >> hi && dash == '-') ? hi : lo;
+    for(unsigned c = lo; c <= hi; ++c)
+    {
+      out.push_back(c);
+    }
+  }
+  return out;
+}
+
+/**
+ *  @brief Read a whole file into a string.
+ *
+ *  @param path file to read.
+ *  @param out set to the file contents.
+ *  @return whether the file could be opened.
+ */
+inline bool NumaTopology::readFile(const std::string &path, std::string &out)
+{
+  std::ifstream in(path.c_str());
+  if(!in)
+  {
+    return false;
+  }
+  std::ostringstream buf;
+  buf << in.rdbuf();
+  out = buf.str();
+  return true;
+}
+
+/**
+ *  @brief Constructs an empty ShardedQueue with one shard per node.
+ *
+ *  Each shard is allocated by a short lived thread bound to the cpus of its
+ *  node so first touch places it there. Binding failures, e.g. inside a
+ *  restricted cpuset, are ignored and only cost locality.
+ *
+ *  Complexity:\n
+ *    O(k) thread creations where k is the number of nodes.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of each shard's heap.
+ *  @param numa nodes to create shards for.
+ */
+template <class T, class Tuning>
+ShardedQueue<T, Tuning>::ShardedQueue(const NumaTopology &numa) :
+  topology(numa), shards(numa.nodes())
+{
+  for(size_t n = 0; n < shards.size(); ++n)
+  {
+    std::unique_ptr<Shard> &shard = shards[n];
+    const std::vector<unsigned> &cpus = topology.cpusOf(n);
+    std::thread([&shard, &cpus]()
+    {
+      bindToNode(cpus);
+      shard.reset(new Shard);
+      shard->count.store(0, std::memory_order_relaxed);
+    }).join();
+    steal.push_back(topology.byDistance(n));
+  }
+}
+
+/**
+ *  @brief Returns the number of shards, one per node.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of each shard's heap.
+ */
+template <class T, class Tuning>
+size_t ShardedQueue<T, Tuning>::shardCount() const noexcept
+{
+  return shards.size();
+}
+
+/**
+ *  @brief Returns the total number of entries over all shards.
+ *
+ *  Shards are read one after the other without locking, so the result is
+ *  only exact when no other thread is modifying the queue.
+ *
+ *  Complexity:\n
+ *    O(k) where k is the number of shards.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of each shard's heap.
+ */
+template <class T, class Tuning>
+size_t ShardedQueue<T, Tuning>::size() const noexcept
+{
+  size_t total = 0;
+  for(size_t n = 0; n < shards.size(); ++n)
+  {
+    total += shards[n]->count.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+/**
+ *  @brief Inserts a new entry into the shard of the calling thread's node.
+ *
+ *  Complexity:\n
+ *    O(log(n)) amortized, where n is the size of the local shard.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of each shard's heap.
+ *  @param val new object to be stored, will be copied.
+ */
+template <class T, class Tuning>
+void ShardedQueue<T, Tuning>::insert(T val)
+{
+  insert(val, topology.currentNode());
+}
+
+/**
+ *  @brief Inserts a new entry into the shard of a given node.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of each shard's heap.
+ *  @param val new object to be stored, will be copied.
+ *  @param node dense node index of the shard.
+ */
+template <class T, class Tuning>
+void ShardedQueue<T, Tuning>::insert(T val, size_t node)
+{
+  Shard &shard = *shards[node];
+  std::lock_guard<std::mutex> guard(shard.lock);
+  shard.queue.insert(val);
+  shard.count.store(shard.queue.size(), std::memory_order_relaxed);
+}
+
+/**
+ *  @brief Removes the minimum entry of the calling thread's shard, stealing
+ *  from the nearest non-empty shard when the local one is empty.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of each shard's heap.
+ *  @param out set to the removed entry.
+ *  @return false if every shard was empty.
+ */
+template <class T, class Tuning>
+bool ShardedQueue<T, Tuning>::tryRemoveMin(T &out)
+{
+  return tryRemoveMin(out, topology.currentNode());
+}
+
+/**
+ *  @brief Removes the minimum entry of a given node's shard, stealing from
+ *  the nearest non-empty shard when it is empty.
+ *
+ *  Complexity:\n
+ *    O(log(n)) for the shard removed from, plus O(k) to find it.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of each shard's heap.
+ *  @param out set to the removed entry.
+ *  @param node dense node index to remove from first.
+ *  @return false if every shard was empty.
+ */
+template <class T, class Tuning>
+bool ShardedQueue<T, Tuning>::tryRemoveMin(T &out, size_t node)
+{
+  const std::vector<size_t> &order = steal[node];
+  for(size_t i = 0; i < order.size(); ++i)
+  {
+    if(shards[order[i]]->count.load(std::memory_order_relaxed) != 0 &&
+      tryRemoveLocal(out, order[i]))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ *  @brief Removes the minimum entry of one shard.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of each shard's heap.
+ *  @param out set to the removed entry.
+ *  @param node dense node index of the shard.
+ *  @return false if the shard was empty once locked.
+ */
+template <class T, class Tuning>
+bool ShardedQueue<T, Tuning>::tryRemoveLocal(T &out, size_t node)
+{
+  Shard &shard = *shards[node];
+  std::lock_guard<std::mutex> guard(shard.lock);
+  if(shard.queue.size() == 0)
+  {
+    return false;
+  }
+  out = shard.queue.removeMin();
+  shard.count.store(shard.queue.size(), std::memory_order_relaxed);
+  return true;
+}
+
+/**
+ *  @brief Bind the calling thread to a set of cpus.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Tuning arity and prefetch distance of each shard's heap.
+ *  @param cpus cpus to run on, nothing is done when empty.
+ */
+template <class T, class Tuning>
+void ShardedQueue<T, Tuning>::bindToNode(const std::vector<unsigned> &cpus)
+{
+  if(cpus.empty())
+  {
+    return;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for(size_t i = 0; i < cpus.size(); ++i)
+  {
+    if(cpus[i] < CPU_SETSIZE)
+    {
+      CPU_SET(cpus[i], &set);
+    }
+  }
+  sched_setaffinity(0, sizeof(set), &set);
+}
@@ -0,0 +1,167 @@
+#ifndef SHARED_QUEUE_H
+#define SHARED_QUEUE_H
+#include <atomic>
+#include <string>
+#include <type_traits>
+#include <pthread.h>
+#include "futex.h"
+#include "priority_queue.h"
+
+/**
+ *  SharedStorage is a Storage for PriorityQueue that views an array and its
+ *  length kept elsewhere, such as in a shared memory segment. Copies view
+ *  the same array. push_back() does not check capacity, the owner of the
+ *  array does.
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored.
+ *
+ *  Member Variables:\n
+ *    count number of entries in the array, including the filler.
+ *    data the array.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) view an array and its length.
+ *    - size() return the number of entries.
+ *    - operator[] access an entry.
+ *    - push_back() append an entry.
+ *    - pop_back() remove the last entry.
+ *  </p>
+ */
+template <class T>
+class SharedStorage
+{
+  public:
+    SharedStorage(size_t *, T *) noexcept;
+    size_t size() const noexcept;
+    const T &operator[](size_t) const noexcept;
+    T &operator[](size_t) noexcept;
+    void push_back(const T &) noexcept;
+    void pop_back() noexcept;
+
+  private:
+    size_t *count;
+    T *data;
+};
+
+/**
+ *  SharedPriorityQueue class defines a min-heap that lives in a POSIX
+ *  shared memory segment, so processes on one host can share it without a
+ *  broker process.
+ *
+ *  <p>
+ *  The segment starts with a Header holding the heap's length, a process
+ *  shared robust mutex and a shared Futex, followed by the heap array at an
+ *  offset recorded in the header. Nothing in the segment is a pointer, so
+ *  every process may map it at a different address. Each process runs the
+ *  ordinary PriorityQueue algorithms on the mapped array through a
+ *  SharedStorage. Consumers that find the queue empty sleep on the Futex,
+ *  and push() wakes one of them only when one is registered, as in
+ *  BlockingPriorityQueue.
+ *  </p>
+ *
+ *  <p>
+ *  The first process to open a name creates and initializes the segment,
+ *  later ones wait up to about a second until it is ready, check that its
+ *  layout fits the segment, and adopt its capacity. The capacity
+ *  is fixed, push() fails when the queue is full. Entries are copied
+ *  bytewise between processes, so T must be trivially copyable and must
+ *  not hold pointers into one process's memory.
+ *  </p>
+ *
+ *  <p>
+ *  If a process dies holding the lock, the next process to lock it is told
+ *  so by the robust mutex and rebuilds heap order before continuing. An
+ *  operation cut short may have left one entry duplicated or lost, never a
+ *  corrupt queue.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the SharedPriorityQueue().
+ *    Key projection of T the heap is ordered by, defaults to Identity.
+ *    Tuning arity and prefetch distance of the heap.
+ *
+ *  Member Variables:\n
+ *    mapping the mapped segment and its size.
+ *    queue PriorityQueue over the segment's array.
+ *    TEST macro used for tests to access private members.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) create or open a named segment, throws
+ *        std::system_error on failure.
+ *    - (Destructor) unmap the segment, which outlives it until unlink().
+ *    - unlink() remove a named segment.
+ *    - size() return the number of entries.
+ *    - capacity() return the maximum number of entries.
+ *    - push() insert an entry, waking one waiting consumer.
+ *    - pop() remove the minimum entry, blocking while empty.
+ *    - tryPop() remove the minimum entry if there is one.
+ *    - attach() private helper map a segment, creating it if needed.
+ *    - lock(), unlock() private helpers take and release the mutex, lock()
+ *        throws std::system_error if the mutex is unrecoverable.
+ *    - repair() private helper restore heap order after a process died.
+ *  </p>
+ */
+template <class T, class Key = Identity<T>,
+  class Tuning = PriorityQueueTuning<sizeof(T)> >
+class SharedPriorityQueue
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+    "entries are copied between processes bytewise");
+
+  public:
+    SharedPriorityQueue(const std::string &, size_t, const Key & = Key());
+    ~SharedPriorityQueue();
+    SharedPriorityQueue(const SharedPriorityQueue &) = delete;
+    SharedPriorityQueue &operator=(const SharedPriorityQueue &) = delete;
+    static bool unlink(const std::string &) noexcept;
+    size_t size();
+    size_t capacity() const noexcept;
+    bool push(T);
+    T pop();
+    bool tryPop(T &);
+
+  private:
+    /**
+     *  Header is the start of the segment.
+     */
+    struct Header
+    {
+      std::atomic<unsigned> ready;
+      size_t entrySize;
+      size_t capacity;
+      size_t offset;
+      size_t count;
+      size_t waiters;
+      pthread_mutex_t lock;
+      Futex available;
+    };
+
+    /**
+     *  Mapping is the address and length of the mapped segment.
+     */
+    struct Mapping
+    {
+      Header *header;
+      size_t bytes;
+      T *entries() const noexcept
+      {
+        return reinterpret_cast<T *>(
+          reinterpret_cast<char *>(header) + header->offset);
+      }
+    };
+    static const unsigned magic = 0x50515348;
+    static const unsigned attachPolls = 1000;
+    static Mapping attach(const std::string &, size_t);
+    void lock();
+    void unlock() noexcept;
+    void repair();
+    Mapping mapping;
+    PriorityQueue<T, Key, Tuning, SharedStorage<T> > queue;
+    TEST;
+};
+
+#include "shared_queue.hxx"
+#endif
@@ -0,0 +1,452 @@
+#include <cerrno>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  The creator opens the name with O_EXCL, sizes and initializes the
+ *  segment, then publishes ready with a release store. Other processes may
+ *  open the name before it is sized, so they wait for a non-zero size,
+ *  map it, and wait for ready before touching anything else.
+ *  </p>
+ *
+ *  <p>
+ *  The array holds capacity entries after the filler at position 0, and
+ *  starts on a cache line boundary after the header.
+ *  </p>
+ *
+ *  <p>
+ *  waiters counts consumers about to sleep, under the lock, like in
+ *  BlockingPriorityQueue. A consumer that dies while registered leaves the
+ *  count too high, which only costs producers a needless wake.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs a view of an array and its length.
+ *
+ *  @tparam T type of object stored.
+ *  @param count length of the array, updated by push_back() and pop_back().
+ *  @param data the array.
+ */
+template <class T>
+SharedStorage<T>::SharedStorage(size_t *count, T *data) noexcept :
+  count(count), data(data)
+{
+}
+
+/**
+ *  @brief Returns the number of entries.
+ *
+ *  @tparam T type of object stored.
+ */
+template <class T>
+size_t SharedStorage<T>::size() const noexcept
+{
+  return *count;
+}
+
+/**
+ *  @brief Returns an entry.
+ *
+ *  @tparam T type of object stored.
+ *  @param i position of the entry.
+ */
+template <class T>
+const T &SharedStorage<T>::operator[](size_t i) const noexcept
+{
+  return data[i];
+}
+
+/**
+ *  @brief Returns an entry.
+ *
+ *  @tparam T type of object stored.
+ *  @param i position of the entry.
+ */
+template <class T>
+T &SharedStorage<T>::operator[](size_t i) noexcept
+{
+  return data[i];
+}
+
+/**
+ *  @brief Appends an entry. The entry is written before the length grows,
+ *  so a process dying in between leaves no garbage in the array.
+ *
+ *  @tparam T type of object stored.
+ *  @param val entry to append.
+ */
+template <class T>
+void SharedStorage<T>::push_back(const T &val) noexcept
+{
+  data[*count] = val;
+  ++*count;
+}
+
+/**
+ *  @brief Removes the last entry.
+ *
+ *  @tparam T type of object stored.
+ */
+template <class T>
+void SharedStorage<T>::pop_back() noexcept
+{
+  --*count;
+}
+
+/**
+ *  @brief Opens the named queue, creating it with a given capacity if it
+ *  does not exist yet.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param name shared memory object name, e.g. "/jobs".
+ *  @param capacity maximum number of entries, ignored if the queue exists.
+ *  @param key projection of entries compared by the heap.
+ */
+template <class T, class Key, class Tuning>
+SharedPriorityQueue<T, Key, Tuning>::SharedPriorityQueue(
+  const std::string &name, size_t capacity, const Key &key) :
+  mapping(attach(name, capacity)),
+  queue(key, SharedStorage<T>(&mapping.header->count, mapping.entries()))
+{
+}
+
+/**
+ *  @brief Unmaps the segment. The queue and its entries persist until
+ *  unlink() and the last process unmapping it.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Key, class Tuning>
+SharedPriorityQueue<T, Key, Tuning>::~SharedPriorityQueue()
+{
+  munmap(mapping.header, mapping.bytes);
+}
+
+/**
+ *  @brief Removes a named queue, processes that have it mapped keep using
+ *  it.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param name shared memory object name.
+ *  @return false if there was no such queue.
+ */
+template <class T, class Key, class Tuning>
+bool SharedPriorityQueue<T, Key, Tuning>::unlink(
+  const std::string &name) noexcept
+{
+  return shm_unlink(name.c_str()) == 0;
+}
+
+/**
+ *  @brief Returns the number of entries.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Key, class Tuning>
+size_t SharedPriorityQueue<T, Key, Tuning>::size()
+{
+  lock();
+  size_t n = queue.size();
+  unlock();
+  return n;
+}
+
+/**
+ *  @brief Returns the maximum number of entries.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Key, class Tuning>
+size_t SharedPriorityQueue<T, Key, Tuning>::capacity() const noexcept
+{
+  return mapping.header->capacity;
+}
+
+/**
+ *  @brief Inserts a new entry and wakes one waiting consumer, if any.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size(), plus one futex wake when a consumer is
+ *    waiting.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param val new object to be stored, will be copied.
+ *  @return false if the queue is full.
+ */
+template <class T, class Key, class Tuning>
+bool SharedPriorityQueue<T, Key, Tuning>::push(T val)
+{
+  Header &h = *mapping.header;
+  lock();
+  if(queue.size() == h.capacity)
+  {
+    unlock();
+    return false;
+  }
+  queue.insert(val);
+  bool wake = h.waiters != 0;
+  unlock();
+  if(wake)
+  {
+    h.available.bump();
+    h.available.wake(01);
+  }
+  return true;
+}
+
+/**
+ *  @brief Removes the minimum entry, blocking while the queue is empty.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size(), once an entry is available.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @return T the minimum entry.
+ */
+template <class T, class Key, class Tuning>
+T SharedPriorityQueue<T, Key, Tuning>::pop()
+{
+  Header &h = *mapping.header;
+  lock();
+  while(queue.size() == 0)
+  {
+    unsigned seen = h.available.load();
+    ++h.waiters;
+    unlock();
+    h.available.wait(seen);
+    lock();
+    --h.waiters;
+  }
+  T val = queue.removeMin();
+  unlock();
+  return val;
+}
+
+/**
+ *  @brief Removes the minimum entry if there is one.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param out set to the removed entry.
+ *  @return false if the queue was empty.
+ */
+template <class T, class Key, class Tuning>
+bool SharedPriorityQueue<T, Key, Tuning>::tryPop(T &out)
+{
+  lock();
+  bool found = queue.size() != 0;
+  if(found)
+  {
+    out = queue.removeMin();
+  }
+  unlock();
+  return found;
+}
+
+/**
+ *  @brief Map a named segment, creating and initializing it if it does not
+ *  exist.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ *  @param name shared memory object name.
+ *  @param capacity maximum number of entries of a new segment.
+ *  @return the mapping.
+ *  @throws std::system_error with ETIMEDOUT if the creator never finishes,
+ *    EINVAL if the segment does not hold a queue of T.
+ */
+template <class T, class Key, class Tuning>
+typename SharedPriorityQueue<T, Key, Tuning>::Mapping
+  SharedPriorityQueue<T, Key, Tuning>::attach(const std::string &name,
+  size_t capacity)
+{
+  const size_t offset = (sizeof(Header) + 0x3f) & ~(size_t)0x3f;
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  bool creator = fd >= 0;
+  if(!creator && errno == EEXIST)
+  {
+    fd = shm_open(name.c_str(), O_RDWR, 0);
+  }
+  if(fd < 0)
+  {
+    throw std::system_error(errno, std::system_category(), "shm_open");
+  }
+
+  Mapping m;
+  m.bytes = offset + (capacity + 01) * sizeof(T);
+  if(creator && ftruncate(fd, m.bytes) != 0)
+  {
+    int error = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    throw std::system_error(error, std::system_category(), "ftruncate");
+  }
+  if(!creator)
+  {
+    struct stat st;
+    for(unsigned polls = 0; ; ++polls)
+    {
+      if(fstat(fd, &st) != 0)
+      {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::system_category(), "fstat");
+      }
+      if(st.st_size != 0)
+      {
+        break;
+      }
+      if(polls == attachPolls)
+      {
+        close(fd);
+        throw std::system_error(ETIMEDOUT, std::system_category(),
+          "shared queue never sized");
+      }
+      usleep(1000);
+    }
+    if((size_t)st.st_size < sizeof(Header))
+    {
+      close(fd);
+      throw std::system_error(EINVAL, std::system_category(),
+        "shared queue segment size");
+    }
+    m.bytes = st.st_size;
+  }
+  void *p = mmap(NULL, m.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int error = errno;
+  close(fd);
+  if(p == MAP_FAILED)
+  {
+    throw std::system_error(error, std::system_category(), "mmap");
+  }
+  m.header = static_cast<Header *>(p);
+  Header &h = *m.header;
+
+  if(creator)
+  {
+    h.entrySize = sizeof(T);
+    h.capacity = capacity;
+    h.offset = offset;
+    h.count = 01;
+    h.waiters = 0;
+    new(&h.available) Futex(true);
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&h.lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    h.ready.store(magic, std::memory_order_release);
+  }
+  for(unsigned polls = 0; h.ready.load(std::memory_order_acquire) != magic;
+    ++polls)
+  {
+    if(polls == attachPolls)
+    {
+      munmap(p, m.bytes);
+      throw std::system_error(ETIMEDOUT, std::system_category(),
+        "shared queue never ready");
+    }
+    usleep(1000);
+  }
+  //capacity + 1 entries must fit, written so a bogus capacity cannot wrap
+  if(h.entrySize != sizeof(T) || h.offset < sizeof(Header) ||
+    h.offset > m.bytes || h.capacity >= (m.bytes - h.offset) / sizeof(T))
+  {
+    munmap(p, m.bytes);
+    throw std::system_error(EINVAL, std::system_category(),
+      "shared queue layout");
+  }
+  return m;
+}
+
+/**
+ *  @brief Take the mutex, repairing the heap if its last owner died.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Key, class Tuning>
+void SharedPriorityQueue<T, Key, Tuning>::lock()
+{
+  int error = pthread_mutex_lock(&mapping.header->lock);
+  if(error == EOWNERDEAD)
+  {
+    repair();
+    pthread_mutex_consistent(&mapping.header->lock);
+  }
+  else if(error != 0)
+  {
+    throw std::system_error(error, std::system_category(),
+      "pthread_mutex_lock");
+  }
+}
+
+/**
+ *  @brief Release the mutex.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Key, class Tuning>
+void SharedPriorityQueue<T, Key, Tuning>::unlock() noexcept
+{
+  pthread_mutex_unlock(&mapping.header->lock);
+}
+
+/**
+ *  @brief Restore heap order after a process died inside an operation.
+ *
+ *  The length is clamped to the capacity, then every entry is sifted up
+ *  in turn into the heap formed by the entries before it, reusing insert()
+ *  in place.
+ *
+ *  Complexity:\n
+ *    O(n log(n)) where n is size().
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection of T the heap is ordered by.
+ *  @tparam Tuning arity and prefetch distance of the heap.
+ */
+template <class T, class Key, class Tuning>
+void SharedPriorityQueue<T, Key, Tuning>::repair()
+{
+  Header &h = *mapping.header;
+  size_t n = h.count;
+  if(n == 0 || n > h.capacity + 01)
+  {
+    n = n == 0 ? 01 : h.capacity + 01;
+  }
+  T *entries = mapping.entries();
+  for(size_t i = 01; i < n; ++i)
+  {
+    h.count = i;
+    queue.insert(entries[i]);
+  }
+  h.count = n;
+}
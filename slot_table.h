@@ -0,0 +1,65 @@
+#ifndef SLOT_TABLE_H
+#define SLOT_TABLE_H
+#include <cstddef>
+#include <vector>
+
+/**
+ *  SlotTable class defines a hash set of slot numbers, the indices of
+ *  entries kept in a fixed array elsewhere, stored in one flat array with
+ *  open addressing.
+ *
+ *  <p>
+ *  The table never hashes or compares entries itself. The caller passes
+ *  the hash of an entry, which is kept beside its slot, and find() takes a
+ *  predicate telling whether a slot holds the entry looked for, so entries
+ *  are looked up without being copied anywhere first. Cells whose hash
+ *  differs are skipped without calling the predicate.
+ *  </p>
+ *
+ *  <p>
+ *  The table has at least twice as many cells as slots it may hold, so
+ *  linear probes stay short, and is sized once by the constructor. insert(),
+ *  erase() and clear() never allocate. Erasing shifts later cells of the
+ *  probe sequence back instead of leaving tombstones, so a table reused for
+ *  many generations of slots does not degrade.
+ *  </p>
+ *
+ *  Member Variables:\n
+ *    cells the table, a power of two in size, empty cells holding absent.
+ *    mask size of cells minus one.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) size the table for a number of slots.
+ *    - find() return the slot matching a predicate among those of a hash.
+ *    - insert() add a slot.
+ *    - erase() remove a slot.
+ *    - clear() remove every slot.
+ *  </p>
+ */
+class SlotTable
+{
+  public:
+    enum { absent = ~0u };
+    explicit SlotTable(size_t);
+    template <class Match>
+    unsigned find(size_t, Match) const;
+    void insert(size_t, unsigned) noexcept;
+    void erase(size_t, unsigned) noexcept;
+    void clear() noexcept;
+
+  private:
+    /**
+     *  Cell is a slot and the hash of its entry.
+     */
+    struct Cell
+    {
+      size_t hash;
+      unsigned slot;
+    };
+    std::vector<Cell> cells;
+    size_t mask;
+};
+
+#include "slot_table.hxx"
+#endif
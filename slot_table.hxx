@@ -0,0 +1,131 @@
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  A slot lives in the first empty cell at or after the cell its hash
+ *  maps to, its home. Erasing empties the slot's cell, then walks the
+ *  cells after it up to the next empty one and moves back the first whose
+ *  home is not between the emptied cell and itself, repeating from the cell
+ *  it vacated. Every slot therefore stays reachable from its home without
+ *  crossing an empty cell.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty table with room for a number of slots.
+ *
+ *  @param slots the most slots held at once.
+ */
+inline SlotTable::SlotTable(size_t slots)
+{
+  size_t size = 02;
+  while(size < 02 * slots)
+  {
+    size <<= 01;
+  }
+  Cell empty = {0, absent};
+  cells.assign(size, empty);
+  mask = size - 01;
+}
+
+/**
+ *  @brief Returns the slot of an entry, found by its hash and a predicate.
+ *
+ *  Complexity:\n
+ *    Constant on average.
+ *
+ *  @tparam Match predicate on a slot number.
+ *  @param hash the hash of the entry looked for.
+ *  @param match returns whether a slot holds the entry looked for.
+ *  @return the slot, absent if none matches.
+ */
+template <class Match>
+unsigned SlotTable::find(size_t hash, Match match) const
+{
+  for(size_t i = hash & mask; cells[i].slot != absent; i = (i + 01) & mask)
+  {
+    if(cells[i].hash == hash && match(cells[i].slot))
+    {
+      return cells[i].slot;
+    }
+  }
+  return absent;
+}
+
+/**
+ *  @brief Adds a slot.
+ *
+ *  Complexity:\n
+ *    Constant on average.
+ *
+ *  Precondition:\n
+ *    The slot is not in the table, which holds fewer slots than it was
+ *    constructed for.
+ *
+ *  @param hash the hash of the slot's entry.
+ *  @param slot the slot.
+ */
+inline void SlotTable::insert(size_t hash, unsigned slot) noexcept
+{
+  size_t i = hash & mask;
+  while(cells[i].slot != absent)
+  {
+    i = (i + 01) & mask;
+  }
+  cells[i].hash = hash;
+  cells[i].slot = slot;
+}
+
+/**
+ *  @brief Removes a slot.
+ *
+ *  Complexity:\n
+ *    Constant on average.
+ *
+ *  Precondition:\n
+ *    The slot is in the table, inserted with the same hash.
+ *
+ *  @param hash the hash the slot was inserted with.
+ *  @param slot the slot.
+ */
+inline void SlotTable::erase(size_t hash, unsigned slot) noexcept
+{
+  size_t i = hash & mask;
+  while(cells[i].slot != slot)
+  {
+    i = (i + 01) & mask;
+  }
+  for(size_t j = i; ; )
+  {
+    cells[i].slot = absent;
+    for(;;)
+    {
+      j = (j + 01) & mask;
+      if(cells[j].slot == absent)
+      {
+        return;
+      }
+      //j may fill i only if its home is at or before i, cyclically
+      size_t home = cells[j].hash & mask;
+      if(((j - home) & mask) >= ((j - i) & mask))
+      {
+        break;
+      }
+    }
+    cells[i] = cells[j];
+    i = j;
+  }
+}
+
+/**
+ *  @brief Removes every slot.
+ *
+ *  Complexity:\n
+ *    Linear in the size of the table, without allocating.
+ */
+inline void SlotTable::clear() noexcept
+{
+  for(size_t i = 0; i < cells.size(); ++i)
+  {
+    cells[i].slot = absent;
+  }
+}
@@ -0,0 +1,124 @@
+#ifndef SPACE_SAVING_H
+#define SPACE_SAVING_H
+#include <functional>
+#include <vector>
+#include "indexed_heap.h"
+#include "slot_table.h"
+
+/**
+ *  SpaceSaving class finds the heavy hitters of a stream with k counters,
+ *  following Metwally, Agrawal and El Abbadi.
+ *
+ *  <p>
+ *  Each counter monitors one item with its count and the error the count
+ *  may overstate by. An item already monitored has its count raised. Any
+ *  other item takes over the counter of least count, inheriting that count
+ *  as its error. Counts therefore overestimate true frequencies by at most
+ *  N/k for a stream of total weight N, and every item more frequent than
+ *  N/k is monitored.
+ *  </p>
+ *
+ *  <p>
+ *  Counters live in k fixed slots. An IndexedHeap of the slots by count
+ *  finds the least in O(1) and reorders a raised count in O(log(k)), and a
+ *  SlotTable of the slots finds an item's counter in O(1). Nothing is
+ *  rebuilt or allocated per item. Lookups do not modify the summary, so
+ *  estimate() may run concurrently with other const members, but not with
+ *  offer() or merge().
+ *  </p>
+ *
+ *  <p>
+ *  Summaries of shards of a stream merge into a summary of the whole with
+ *  the same N/k bound, following Agarwal et al.: counts of items in both
+ *  are added, an item missing from a full summary is charged that
+ *  summary's least count, and the k largest are kept.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the items counted, default constructible.
+ *    Hash hash of an item.
+ *    Equal whether two items are the same.
+ *
+ *  Member Variables:\n
+ *    items, counts, errors per slot.
+ *    used number of slots in use.
+ *    total total weight offered.
+ *    hash, equal hash and equality of items.
+ *    byCount IndexedHeap of the used slots by count.
+ *    monitored SlotTable of the used slots, by item.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) take the number of counters, optionally the hash and
+ *        equality.
+ *    - size() return the number of items monitored.
+ *    - capacity() return the number of counters.
+ *    - totalWeight() return the total weight offered.
+ *    - offer() count an occurrence of an item.
+ *    - estimate() return the count and error of an item.
+ *    - top() copy the counters, largest count first.
+ *    - merge() fold in the summary of another shard.
+ *    - least() private helper return the count charged to an item not
+ *        monitored.
+ *    - find() private helper return the slot of an item.
+ *    - assign() private helper set the counter of a slot.
+ *  </p>
+ */
+template <class T, class Hash = std::hash<T>, class Equal = std::equal_to<T> >
+class SpaceSaving
+{
+  public:
+    /**
+     *  Counter is an item monitored, with its count and the error it may
+     *  overstate the true frequency by.
+     */
+    struct Counter
+    {
+      T item;
+      unsigned long long count;
+      unsigned long long error;
+    };
+
+    explicit SpaceSaving(size_t, const Hash & = Hash(),
+      const Equal & = Equal());
+    SpaceSaving(const SpaceSaving &) = delete;
+    SpaceSaving &operator=(const SpaceSaving &) = delete;
+    size_t size() const noexcept;
+    size_t capacity() const noexcept;
+    unsigned long long totalWeight() const noexcept;
+    void offer(const T &, unsigned long long = 01);
+    bool estimate(const T &, unsigned long long &, unsigned long long &)
+      const;
+    void top(std::vector<Counter> &) const;
+    void merge(const SpaceSaving &);
+
+  private:
+    /**
+     *  Field projects a slot to its count.
+     */
+    struct Field
+    {
+      const std::vector<unsigned long long> *values;
+      unsigned long long operator()(unsigned slot) const noexcept
+      {
+        return (*values)[slot];
+      }
+    };
+
+    unsigned long long least() const noexcept;
+    unsigned find(const T &) const;
+    void assign(unsigned, const Counter &);
+    size_t counters;
+    std::vector<T> items;
+    std::vector<unsigned long long> counts;
+    std::vector<unsigned long long> errors;
+    size_t used;
+    unsigned long long total;
+    Hash hash;
+    Equal equal;
+    IndexedHeap<Field> byCount;
+    SlotTable monitored;
+};
+
+#include "space_saving.hxx"
+#endif
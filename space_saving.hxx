@@ -0,0 +1,287 @@
+#include <algorithm>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  As in Beam, the table holds slot numbers with the hash of their items,
+ *  and a slot leaves the table before its item is replaced.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty summary.
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ *  @param k the number of counters.
+ *  @param hash hash of an item.
+ *  @param equal whether two items are the same.
+ */
+template <class T, class Hash, class Equal>
+SpaceSaving<T, Hash, Equal>::SpaceSaving(size_t k, const Hash &hash,
+  const Equal &equal) :
+  counters(k), items(k), counts(k, 0), errors(k, 0), used(0), total(0),
+  hash(hash), equal(equal), byCount(Field{&counts}), monitored(k)
+{
+  byCount.reserve(k);
+}
+
+/**
+ *  @brief Returns the number of items monitored.
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ */
+template <class T, class Hash, class Equal>
+size_t SpaceSaving<T, Hash, Equal>::size() const noexcept
+{
+  return used;
+}
+
+/**
+ *  @brief Returns the number of counters.
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ */
+template <class T, class Hash, class Equal>
+size_t SpaceSaving<T, Hash, Equal>::capacity() const noexcept
+{
+  return counters;
+}
+
+/**
+ *  @brief Returns the total weight offered, including merged summaries.
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ */
+template <class T, class Hash, class Equal>
+unsigned long long SpaceSaving<T, Hash, Equal>::totalWeight() const noexcept
+{
+  return total;
+}
+
+/**
+ *  @brief Counts an occurrence of an item.
+ *
+ *  Complexity:\n
+ *    One hash lookup and O(log(k)) where k is capacity().
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ *  @param item the item.
+ *  @param weight the weight of the occurrence, e.g. bytes of a flow.
+ */
+template <class T, class Hash, class Equal>
+void SpaceSaving<T, Hash, Equal>::offer(const T &item,
+  unsigned long long weight)
+{
+  if(counters == 0)
+  {
+    return;
+  }
+  total += weight;
+  unsigned slot = find(item);
+  if(slot != SlotTable::absent)
+  {
+    counts[slot] += weight;
+    byCount.update(slot);
+    return;
+  }
+  Counter c = {item, weight, 0};
+  if(used < counters)
+  {
+    slot = used++;
+  }
+  else
+  {
+    slot = byCount.top();
+    monitored.erase(hash(items[slot]), slot);
+    c.count += counts[slot];
+    c.error = counts[slot];
+  }
+  assign(slot, c);
+}
+
+/**
+ *  @brief Returns the estimate of an item's frequency.
+ *
+ *  The true frequency is between count - error and count. An item that is
+ *  not monitored occurred at most as often as the least count, reported as
+ *  both its count and its error, or not at all while the summary has free
+ *  counters.
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ *  @param item the item.
+ *  @param count set to the upper bound.
+ *  @param error set to the overestimate bound.
+ *  @return whether the item is monitored.
+ */
+template <class T, class Hash, class Equal>
+bool SpaceSaving<T, Hash, Equal>::estimate(const T &item,
+  unsigned long long &count, unsigned long long &error) const
+{
+  unsigned slot = find(item);
+  if(slot == SlotTable::absent)
+  {
+    count = error = least();
+    return false;
+  }
+  count = counts[slot];
+  error = errors[slot];
+  return true;
+}
+
+/**
+ *  @brief Copies the counters, largest count first.
+ *
+ *  Complexity:\n
+ *    O(k log(k)) where k is size().
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ *  @param out replaced by the counters.
+ */
+template <class T, class Hash, class Equal>
+void SpaceSaving<T, Hash, Equal>::top(std::vector<Counter> &out) const
+{
+  out.clear();
+  for(unsigned slot = 0; slot < used; ++slot)
+  {
+    Counter c = {items[slot], counts[slot], errors[slot]};
+    out.push_back(c);
+  }
+  std::sort(out.begin(), out.end(), [](const Counter &a, const Counter &b)
+  {
+    return b.count < a.count;
+  });
+}
+
+/**
+ *  @brief Folds in the summary of another shard of the stream, making this
+ *  a summary of both.
+ *
+ *  Complexity:\n
+ *    O(k log(k)) where k is capacity().
+ *
+ *  Precondition:\n
+ *    other.capacity() == capacity()
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ *  @param other the other summary, unchanged.
+ */
+template <class T, class Hash, class Equal>
+void SpaceSaving<T, Hash, Equal>::merge(const SpaceSaving &other)
+{
+  unsigned long long ownLeast = least();
+  unsigned long long otherLeast = other.least();
+  std::vector<bool> matched(used, false);
+  std::vector<Counter> all;
+  for(unsigned o = 0; o < other.used; ++o)
+  {
+    Counter c = {other.items[o], other.counts[o], other.errors[o]};
+    unsigned slot = find(c.item);
+    if(slot != SlotTable::absent)
+    {
+      matched[slot] = true;
+      c.count += counts[slot];
+      c.error += errors[slot];
+    }
+    else
+    {
+      c.count += ownLeast;
+      c.error += ownLeast;
+    }
+    all.push_back(c);
+  }
+  for(unsigned slot = 0; slot < used; ++slot)
+  {
+    if(!matched[slot])
+    {
+      Counter c = {items[slot], counts[slot] + otherLeast,
+        errors[slot] + otherLeast};
+      all.push_back(c);
+    }
+  }
+  size_t keep = std::min(all.size(), counters);
+  std::nth_element(all.begin(), all.begin() + keep, all.end(),
+    [](const Counter &a, const Counter &b) { return b.count < a.count; });
+
+  monitored.clear();
+  byCount.clear();
+  used = keep;
+  for(unsigned slot = 0; slot < keep; ++slot)
+  {
+    assign(slot, all[slot]);
+  }
+  total += other.total;
+}
+
+/**
+ *  @brief Returns the count charged to an item that is not monitored, the
+ *  least count once every counter is in use and 0 before.
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ */
+template <class T, class Hash, class Equal>
+unsigned long long SpaceSaving<T, Hash, Equal>::least() const noexcept
+{
+  return used == 0 || used < counters ? 0 : counts[byCount.top()];
+}
+
+/**
+ *  @brief Returns the slot monitoring an item, SlotTable::absent if none.
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ *  @param item the item.
+ */
+template <class T, class Hash, class Equal>
+unsigned SpaceSaving<T, Hash, Equal>::find(const T &item) const
+{
+  return monitored.find(hash(item), [this, &item](unsigned slot)
+  {
+    return equal(items[slot], item);
+  });
+}
+
+/**
+ *  @brief Sets the counter of a slot that is not in the table of monitored
+ *  slots.
+ *
+ *  @tparam T type of the items counted.
+ *  @tparam Hash hash of an item.
+ *  @tparam Equal whether two items are the same.
+ *  @param slot the slot.
+ *  @param c the counter.
+ */
+template <class T, class Hash, class Equal>
+void SpaceSaving<T, Hash, Equal>::assign(unsigned slot, const Counter &c)
+{
+  items[slot] = c.item;
+  counts[slot] = c.count;
+  errors[slot] = c.error;
+  monitored.insert(hash(c.item), slot);
+  if(byCount.contains(slot))
+  {
+    byCount.update(slot);
+  }
+  else
+  {
+    byCount.push(slot);
+  }
+}
@@ -0,0 +1,105 @@
+#ifndef STRING_PREFIX_QUEUE_H
+#define STRING_PREFIX_QUEUE_H
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include "priority_queue.h"
+
+/**
+ *  StringPrefixQueue class defines a min-heap of entries ordered by a string
+ *  that compares most entries without reading the strings' buffers.
+ *
+ *  <p>
+ *  A PriorityQueue<std::string> follows the heap buffer of both strings in
+ *  every comparison. StringPrefixQueue stores the first 8 bytes of each key
+ *  inline beside its entry as a big-endian integer, zero padded when the key
+ *  is shorter. Integer order of the prefixes is the byte order of the
+ *  strings, so comparisons of different prefixes are decided without
+ *  touching the strings, and only equal prefixes fall back to comparing the
+ *  full keys.
+ *  </p>
+ *
+ *  <p>
+ *  The gain depends on how soon keys differ. Keys sharing a long common
+ *  start, such as URLs that all begin with https://, tie on every prefix and
+ *  are better keyed by the part after it.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the entries stored in the StringPrefixQueue().
+ *    Key projection returning a const std::string & into the entry it is
+ *      given, defaults to Identity for queues of std::string. The heap keeps
+ *      a pointer to that string, so a projection returning by value would
+ *      leave it dangling.
+ *
+ *  Member Variables:\n
+ *    key projection to the string key of an entry.
+ *    queue PriorityQueue of Entry ordered by PrefixKey.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) public constructor, optionally taking the projection.
+ *    - size() return logical size.
+ *    - min() return the minimum entry.
+ *    - removeMin() remove the minimum entry and return it.
+ *    - insert() insert a new entry.
+ *    - prefix() private helper return the big-endian prefix of a string.
+ *  </p>
+ */
+template <class T = std::string, class Key = Identity<T> >
+class StringPrefixQueue
+{
+  static_assert(std::is_reference<decltype(std::declval<const Key &>()(
+    std::declval<const T &>()))>::value,
+    "Key must return a reference to the string inside the entry");
+
+  public:
+    explicit StringPrefixQueue(const Key & = Key());
+    size_t size() const noexcept;
+    T min() const;
+    T removeMin();
+    void insert(T);
+
+  private:
+    /**
+     *  Entry is a queued entry with the prefix of its key.
+     */
+    struct Entry
+    {
+      uint64_t prefix;
+      T val;
+    };
+
+    /**
+     *  Compared is the key the heap compares, the prefix and a pointer to
+     *  the full string, which is only followed when the prefixes are equal.
+     */
+    struct Compared
+    {
+      uint64_t prefix;
+      const std::string *full;
+      bool operator<(const Compared &o) const
+      {
+        return prefix != o.prefix ? prefix < o.prefix : *full < *o.full;
+      }
+    };
+
+    /**
+     *  PrefixKey projects an Entry to what the heap compares.
+     */
+    struct PrefixKey
+    {
+      Key key;
+      Compared operator()(const Entry &e) const
+      {
+        Compared c = {e.prefix, &key(e.val)};
+        return c;
+      }
+    };
+    static uint64_t prefix(const std::string &) noexcept;
+    Key key;
+    PriorityQueue<Entry, PrefixKey> queue;
+};
+
+#include "string_prefix_queue.hxx"
+#endif
@@ -0,0 +1,101 @@
+/**
+ *  @brief Constructs an empty StringPrefixQueue.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection to the string key of an entry.
+ *  @param key projection to the string key of an entry.
+ */
+template <class T, class Key>
+StringPrefixQueue<T, Key>::StringPrefixQueue(const Key &key) :
+  key(key), queue(PrefixKey{key})
+{
+}
+
+/**
+ *  @brief Returns the number of entries.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection to the string key of an entry.
+ */
+template <class T, class Key>
+size_t StringPrefixQueue<T, Key>::size() const noexcept
+{
+  return queue.size();
+}
+
+/**
+ *  @brief Returns the minimum entry without removing it.
+ *
+ *  Precondition:\n
+ *    size() > 0
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection to the string key of an entry.
+ *  @return T the minimum entry.
+ */
+template <class T, class Key>
+T StringPrefixQueue<T, Key>::min() const
+{
+  return queue.min().val;
+}
+
+/**
+ *  @brief Removes the minimum entry and returns it.
+ *
+ *  Complexity:\n
+ *    O(log(n)) comparisons, where n is size(). Only comparisons of keys
+ *    with equal 8 byte prefixes read the strings.
+ *
+ *  Precondition:\n
+ *    size() > 0
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection to the string key of an entry.
+ *  @return T the minimum entry.
+ */
+template <class T, class Key>
+T StringPrefixQueue<T, Key>::removeMin()
+{
+  return queue.removeMin().val;
+}
+
+/**
+ *  @brief Inserts a new entry along with the prefix of its key.
+ *
+ *  Complexity:\n
+ *    O(log(n)) amortized, where n is size().
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection to the string key of an entry.
+ *  @param val new object to be stored, will be copied.
+ */
+template <class T, class Key>
+void StringPrefixQueue<T, Key>::insert(T val)
+{
+  Entry e = {prefix(key(val)), val};
+  queue.insert(e);
+}
+
+/**
+ *  @brief Returns the first 8 bytes of a string as a big-endian integer.
+ *
+ *  Bytes past the end of a shorter string are zero, so a string and the
+ *  same string followed by NUL bytes share a prefix and are told apart by
+ *  the full comparison.
+ *
+ *  @tparam T type of object stored.
+ *  @tparam Key projection to the string key of an entry.
+ *  @param s the key.
+ *
+ *  @return the prefix, ordered as the strings are by std::string::compare.
+ */
+template <class T, class Key>
+uint64_t StringPrefixQueue<T, Key>::prefix(const std::string &s) noexcept
+{
+  uint64_t p = 0;
+  for(size_t i = 0; i < sizeof(p); ++i)
+  {
+    p = p << 010 | (i < s.size() ? (unsigned char)s[i] : 0);
+  }
+  return p;
+}
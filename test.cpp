@@ -16,19 +16,31 @@ template <class T>
 class tester
 {
   public:
-  static bool isHeapOrder(PriorityQueue<T> *);
+  template <class Tuning>
+  static bool isHeapOrder(PriorityQueue<T, Identity<T>, Tuning> *);
+};
+
+/**
+ *  Tuning used to exercise heaps wider than binary, with and without
+ *  prefetching.
+ */
+template <size_t Arity, size_t Prefetch>
+struct tuning
+{
+  static const size_t arity = Arity;
+  static const size_t prefetch = Prefetch;
 };
 
 /**
  *  @brief test the heap-order property of the priority queue.
  *
- *  I.e. make sure that each parent is greater than both its left and right
- *  children.
+ *  I.e. make sure that each parent is greater than all of its children.
  *
  *  @return if the PriorityQueue satisfies the heap order property.
  */
 template <class T>
-bool tester<T>::isHeapOrder(PriorityQueue<T> *p)
+template <class Tuning>
+bool tester<T>::isHeapOrder(PriorityQueue<T, Identity<T>, Tuning> *p)
 //bool tester(PriorityQueue<T> *p)
 {
   bool yes = true;
@@ -39,22 +51,20 @@ bool tester<T>::isHeapOrder(PriorityQueue<T> *p)
     {
       yes &= (p->heap[p->parent(i)] < p->heap[i]);
     }
-    //check left child greater
-    if(p->leftInBounds(i))
+    //check children greater
+    for(size_t c = p->firstChild(i); c <= p->lastChild(i); ++c)
     {
-      yes &= (p->heap[i] < p->heap[p->leftChild(i)]);
-    }
-    //check right child greater
-    if(p->rightInBounds(i))
-    {
-      yes &= (p->heap[i] < p->heap[p->rightChild(i)]);
+      if(c <= p->size())
+      {
+        yes &= (p->heap[i] < p->heap[c]);
+      }
     }
   }
   return yes;
 }
 
 /**
- *  @brief test PriorityQueue.
+ *  @brief test a PriorityQueue with the given Tuning.
  *
  *  Testing procedure:\n
  *  <p>
@@ -63,14 +73,13 @@ bool tester<T>::isHeapOrder(PriorityQueue<T> *p)
  *  - Check the vector's elements match the priority queue
  *  <\p>
  */
-int main(void)
+template <class Tuning>
+void testSorted()
 {
-  PriorityQueue<int> p;
+  PriorityQueue<int, Identity<int>, Tuning> p;
   vector<int> v;
   unsigned int t;
 
-  srand(time(NULL));
-
   for(unsigned int i = 0; i < 0x100; ++i)
   {
     t = rand();
@@ -86,4 +95,54 @@ int main(void)
     assert(tester<int>::isHeapOrder(&p));
     assert(*i == p.removeMin());
   }
+  assert(p.size() == 0);
+}
+
+/**
+ *  @brief test removeIf() with the given Tuning.
+ *
+ *  Testing procedure:\n
+ *  <p>
+ *  - Remove nothing, every other entry, then all but the least few
+ *  - Check the heap-order property and the sorted contents after each
+ *  <\p>
+ */
+template <class Tuning>
+void testRemoveIf()
+{
+  PriorityQueue<int, Identity<int>, Tuning> p;
+  vector<int> v;
+  for(int i = 0; i < 0x200; ++i)
+  {
+    v.push_back(i * 7 % 0x200);
+    p.insert(v.back());
+  }
+  assert(p.removeIf([](int) { return false; }) == 0);
+  assert(p.removeIf([](int x) { return x % 2; }) == 0x100);
+  assert(tester<int>::isHeapOrder(&p));
+  assert(p.removeIf([](int x) { return x >= 0x10; }) == 0xf8);
+  assert(tester<int>::isHeapOrder(&p));
+  for(int i = 0; i < 0x10; i += 2)
+  {
+    assert(p.removeMin() == i);
+  }
+  assert(p.size() == 0 && p.removeIf([](int) { return true; }) == 0);
+}
+
+/**
+ *  @brief test PriorityQueue.
+ *
+ *  Run the sorting test against the default tuning and a few wider heaps.
+ */
+int main(void)
+{
+  srand(time(NULL));
+
+  testSorted<PriorityQueueTuning<sizeof(int)> >();
+  testSorted<tuning<3, 0> >();
+  testSorted<tuning<4, 1> >();
+  testSorted<tuning<8, 2> >();
+  testRemoveIf<PriorityQueueTuning<sizeof(int)> >();
+  testRemoveIf<tuning<3, 0> >();
+  testRemoveIf<tuning<8, 2> >();
 }
@@ -0,0 +1,77 @@
+#include <cassert>
+#include <cstdlib>
+#include <set>
+#include <vector>
+#include "batch_heap.h"
+
+using namespace std;
+
+/**
+ *  @brief test rounds of random batches against a sequential reference for
+ *  a given number of threads.
+ */
+static void testRounds(size_t threads)
+{
+  BatchHeap<int> q(threads);
+  assert(q.threads() == threads);
+  multiset<int> ref;
+  vector<int> batch, out;
+  for(int r = 0; r < 0x100; ++r)
+  {
+    batch.clear();
+    for(int i = rand() % 0x80; i > 0; --i)
+    {
+      batch.push_back(rand() % 0x1000);
+      ref.insert(batch.back());
+    }
+    size_t k = rand() % 0x80;
+    out.clear();
+    q.round(batch, k, out);
+    assert(out.size() == (k < ref.size() ? k : ref.size()));
+    for(size_t i = 0; i < out.size(); ++i)
+    {
+      assert(out[i] == *ref.begin());
+      ref.erase(ref.begin());
+    }
+    assert(q.size() == ref.size());
+  }
+}
+
+/**
+ *  @brief test a skewed round where all the smallest entries are in one
+ *  part, so the merge runs past that part's quota.
+ */
+static void testSkewed()
+{
+  BatchHeap<int> q(04);
+  vector<int> batch, out;
+  for(int i = 0; i < 0x100; ++i)
+  {
+    batch.push_back(i % 04 == 0 ? i : 0x1000 + i);
+  }
+  q.round(batch, 0, out);
+  assert(out.empty() && q.size() == 0x100);
+
+  q.round(vector<int>(), 0x40, out);
+  assert(out.size() == 0x40);
+  for(int i = 0; i < 0x40; ++i)
+  {
+    assert(out[i] == 04 * i);
+  }
+
+  out.clear();
+  q.round(vector<int>(), 0x1000, out);
+  assert(out.size() == 0xc0 && q.size() == 0);
+  for(size_t i = 01; i < out.size(); ++i)
+  {
+    assert(out[i - 01] <= out[i]);
+  }
+}
+
+int main()
+{
+  testRounds(01);
+  testRounds(02);
+  testRounds(05);
+  testSkewed();
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <map>
+#include <utility>
+#include <vector>
+#include "beam.h"
+
+using namespace std;
+
+/**
+ *  Hypothesis is a decoder state with its cost.
+ */
+struct Hypothesis
+{
+  unsigned state;
+  double cost;
+};
+
+/**
+ *  SameState hashes and compares hypotheses by state only.
+ */
+struct SameState
+{
+  size_t operator()(const Hypothesis &h) const { return h.state; }
+  bool operator()(const Hypothesis &a, const Hypothesis &b) const
+  {
+    return a.state == b.state;
+  }
+};
+
+typedef Beam<Hypothesis, MemberKey<Hypothesis, double>, SameState,
+  SameState> HypothesisBeam;
+
+/**
+ *  @brief test that each step keeps the best width distinct states, with
+ *  the best cost of each, against a std::map.
+ */
+static void testAgainstMap()
+{
+  static const size_t widths[] = {0, 01, 05, 0x40};
+  for(size_t w = 0; w < sizeof(widths) / sizeof(*widths); ++w)
+  {
+    HypothesisBeam beam(widths[w], memberKey(&Hypothesis::cost));
+    for(int step = 0; step < 010; ++step)
+    {
+      map<unsigned, double> best;
+      for(int i = 0; i < 0x400; ++i)
+      {
+        Hypothesis h = {(unsigned)(rand() % 0x80), rand() / 65536.0 + i};
+        beam.offer(h);
+        if(!best.count(h.state) || h.cost < best[h.state])
+        {
+          best[h.state] = h.cost;
+        }
+      }
+      vector<pair<double, unsigned> > want;
+      for(map<unsigned, double>::iterator i = best.begin();
+        i != best.end(); ++i)
+      {
+        want.push_back(make_pair(i->second, i->first));
+      }
+      sort(want.begin(), want.end());
+      want.resize(min(want.size(), widths[w]));
+
+      beam.advance();
+      vector<Hypothesis> got;
+      beam.sorted(got);
+      assert(got.size() == want.size() && beam.pending() == 0);
+      for(size_t i = 0; i < got.size(); ++i)
+      {
+        assert(got[i].cost == want[i].first && got[i].state == want[i].second);
+      }
+    }
+  }
+}
+
+/**
+ *  @brief test duplicate handling, the O(1) rejection path and that
+ *  advancing reuses the same two arrays.
+ */
+static void testStep()
+{
+  HypothesisBeam beam(02, memberKey(&Hypothesis::cost));
+  Hypothesis a = {01, 5}, b = {02, 3}, worseA = {01, 6}, betterA = {01, 1};
+  Hypothesis c = {03, 2}, d = {04, 9};
+  assert(beam.offer(a) && beam.offer(b));
+  assert(!beam.offer(worseA) && beam.offer(betterA));
+  assert(beam.pending() == 02);
+  assert(!beam.offer(d));
+  assert(beam.offer(c));
+  const Hypothesis *first = beam.begin();
+  beam.advance();
+  const Hypothesis *second = beam.begin();
+  assert(second != first && beam.size() == 02);
+  vector<Hypothesis> got;
+  beam.sorted(got);
+  assert(got[0].state == 01 && got[0].cost == 1);
+  assert(got[01].state == 03 && got[01].cost == 2);
+
+  beam.offer(d);
+  beam.advance();
+  assert(beam.begin() == first && beam.size() == 01);
+  beam.advance();
+  assert(beam.begin() == second && beam.size() == 0);
+}
+
+/**
+ *  @brief test the defaults on plain ints, whole values being the state.
+ */
+static void testDefaults()
+{
+  Beam<int> beam(03);
+  int values[] = {7, 3, 3, 9, 1, 7, 4};
+  for(size_t i = 0; i < sizeof(values) / sizeof(*values); ++i)
+  {
+    beam.offer(values[i]);
+  }
+  beam.advance();
+  vector<int> got;
+  beam.sorted(got);
+  assert(got.size() == 03 && got[0] == 01 && got[01] == 03 && got[02] == 04);
+}
+
+int main()
+{
+  testAgainstMap();
+  testStep();
+  testDefaults();
+}
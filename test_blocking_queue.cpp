@@ -0,0 +1,93 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "blocking_queue.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ *  @brief test the non-blocking and batch operations on a single thread.
+ */
+static void testSequential()
+{
+  BlockingPriorityQueue<int> q;
+  int out;
+  assert(!q.tryPop(out));
+  q.push(3);
+  q.push(1);
+  q.push(2);
+  assert(q.size() == 3);
+  assert(q.pop() == 1);
+
+  vector<int> batch;
+  assert(q.popN(batch, 5) == 2);
+  assert(batch.size() == 2 && batch[0] == 2 && batch[1] == 3);
+  assert(!q.tryPop(out) && q.size() == 0);
+}
+
+/**
+ *  @brief test that popUntil() times out on an empty queue and returns early
+ *  once an entry is pushed.
+ */
+static void testTimedPop()
+{
+  BlockingPriorityQueue<int> q;
+  int out;
+  steady_clock::time_point start = steady_clock::now();
+  assert(!q.popUntil(out, start + milliseconds(20)));
+  assert(steady_clock::now() - start >= milliseconds(20));
+
+  thread producer([&q]()
+  {
+    this_thread::sleep_for(milliseconds(10));
+    q.push(7);
+  });
+  start = steady_clock::now();
+  assert(q.popUntil(out, system_clock::now() + seconds(10)) && out == 7);
+  assert(steady_clock::now() - start < seconds(5));
+  producer.join();
+}
+
+/**
+ *  @brief test that blocked consumers receive every pushed entry exactly
+ *  once.
+ */
+static void testConsumers()
+{
+  BlockingPriorityQueue<int> q;
+  const int consumers = 4;
+  const int perConsumer = 0x800;
+  atomic<long> sum(0);
+  vector<thread> threads;
+  for(int c = 0; c < consumers; ++c)
+  {
+    threads.push_back(thread([&q, &sum, perConsumer]()
+    {
+      for(int i = 0; i < perConsumer; ++i)
+      {
+        sum += q.pop();
+      }
+    }));
+  }
+  long expect = 0;
+  for(int i = 0; i < consumers * perConsumer; ++i)
+  {
+    q.push(i);
+    expect += i;
+  }
+  for(size_t c = 0; c < threads.size(); ++c)
+  {
+    threads[c].join();
+  }
+  assert(sum == expect && q.size() == 0);
+}
+
+int main(void)
+{
+  testSequential();
+  testTimedPop();
+  testConsumers();
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+#include "bounded_heap.h"
+
+using namespace std;
+
+/**
+ *  Negated ranks ints in descending order.
+ */
+struct Negated
+{
+  int operator()(int v) const { return -v; }
+};
+
+/**
+ *  @brief test that a BoundedHeap keeps the k least of a random stream,
+ *  for several limits, against a full sort.
+ */
+template <class Tuning>
+static void testAgainstSort()
+{
+  static const size_t limits[] = {0, 01, 02, 07, 0x40, 0x1000};
+  for(size_t l = 0; l < sizeof(limits) / sizeof(*limits); ++l)
+  {
+    size_t k = limits[l];
+    BoundedHeap<int, Identity<int>, Tuning> h(k);
+    vector<int> all;
+    for(int i = 0; i < 0x800; ++i)
+    {
+      int v = rand() % 0x400;
+      bool accepts = h.accepts(v);
+      assert(h.offer(v) == accepts);
+      all.push_back(v);
+      assert(h.size() == min<size_t>(k, all.size()));
+    }
+    sort(all.begin(), all.end());
+    all.resize(min(k, all.size()));
+    if(k != 0)
+    {
+      assert(h.worst() == all.back());
+    }
+    vector<int> out;
+    h.drain(out);
+    assert(out == all && h.size() == 0);
+  }
+}
+
+/**
+ *  @brief test that merging heaps built over parts of a stream equals one
+ *  heap over the whole stream.
+ */
+static void testMerge()
+{
+  BoundedHeap<int> whole(0x10), left(0x10), right(0x10);
+  for(int i = 0; i < 0x400; ++i)
+  {
+    int v = rand();
+    whole.offer(v);
+    (i % 03 ? left : right).offer(v);
+  }
+  left.merge(right);
+  vector<int> a, b;
+  whole.drain(a);
+  left.drain(b);
+  assert(a == b);
+}
+
+/**
+ *  @brief test the projection, and that clear() and swap() keep the
+ *  allocation.
+ */
+static void testKeyClearSwap()
+{
+  BoundedHeap<int, Negated> big(03), other(05);
+  for(int i = 0; i < 0x10; ++i)
+  {
+    big.offer(i);
+  }
+  assert(big.worst() == 0xd && !big.accepts(0xd) && big.accepts(0xe));
+
+  const int *data = big.begin();
+  other.swap(big);
+  assert(other.limit() == 03 && big.limit() == 05 && big.size() == 0);
+  assert(other.begin() == data);
+  other.clear();
+  assert(other.size() == 0 && other.begin() == data);
+  other.offer(01);
+  assert(other.begin() == data && *other.begin() == 01);
+}
+
+int main()
+{
+  testAgainstSort<PriorityQueueTuning<sizeof(int)> >();
+  testAgainstSort<PriorityQueueTuning<0x40> >();
+  testMerge();
+  testKeyClearSwap();
+}
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include "branch_and_bound.h"
+
+using namespace std;
+
+/**
+ *  Knapsack is a 0/1 knapsack instance searched item by item, minimizing
+ *  the negated value. The bound is the fractional relaxation over the
+ *  items not yet decided, which are sorted by value per unit of weight.
+ */
+struct Knapsack
+{
+  struct Node
+  {
+    unsigned depth;
+    int value;
+    int weight;
+    unsigned taken;
+  };
+  typedef double Bound;
+
+  vector<int> values;
+  vector<int> weights;
+  int capacity;
+
+  Bound bound(const Node &n) const
+  {
+    double value = n.value;
+    int room = capacity - n.weight;
+    for(size_t i = n.depth; i < values.size() && room > 0; ++i)
+    {
+      int w = min(room, weights[i]);
+      value += (double)values[i] * w / weights[i];
+      room -= w;
+    }
+    return -value;
+  }
+  bool complete(const Node &n) const { return n.depth == values.size(); }
+  void branch(const Node &n, vector<Node> &out) const
+  {
+    Node skip = {n.depth + 01, n.value, n.weight, n.taken};
+    out.push_back(skip);
+    if(n.weight + weights[n.depth] <= capacity)
+    {
+      Node take = {n.depth + 01, n.value + values[n.depth],
+        n.weight + weights[n.depth], n.taken | 01u << n.depth};
+      out.push_back(take);
+    }
+  }
+};
+
+/**
+ *  Lists is a problem whose nodes are not trivially copyable.
+ */
+struct Lists
+{
+  typedef vector<int> Node;
+  typedef int Bound;
+  Bound bound(const Node &n) const { return n.size(); }
+  bool complete(const Node &) const { return true; }
+  void branch(const Node &, vector<Node> &) const {}
+};
+
+/**
+ *  @brief return a hard random instance, values close to weights, with the
+ *  items sorted by value per weight.
+ */
+static Knapsack instance(size_t items)
+{
+  vector<pair<int, int> > v;
+  int total = 0;
+  for(size_t i = 0; i < items; ++i)
+  {
+    int w = rand() % 0x100 + 01;
+    v.push_back(make_pair(w + 0x10 + rand() % 04, w));
+    total += w;
+  }
+  sort(v.begin(), v.end(), [](const pair<int, int> &a,
+    const pair<int, int> &b)
+  {
+    return (long)a.first * b.second > (long)b.first * a.second;
+  });
+  Knapsack k;
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    k.values.push_back(v[i].first);
+    k.weights.push_back(v[i].second);
+  }
+  k.capacity = total / 02;
+  return k;
+}
+
+/**
+ *  @brief return the optimal value by dynamic programming over capacity.
+ */
+static int optimum(const Knapsack &k)
+{
+  vector<int> best(k.capacity + 01, 0);
+  for(size_t i = 0; i < k.values.size(); ++i)
+  {
+    for(int c = k.capacity; c >= k.weights[i]; --c)
+    {
+      best[c] = max(best[c], best[c - k.weights[i]] + k.values[i]);
+    }
+  }
+  return best[k.capacity];
+}
+
+/**
+ *  @brief test that a solve() finds the optimum, and that its incumbent is
+ *  a consistent feasible solution.
+ */
+static void checkSolved(BranchAndBound<Knapsack> &bb, const Knapsack &k)
+{
+  Knapsack::Node root = {0, 0, 0, 0};
+  assert(bb.solve(root));
+  const Knapsack::Node &n = bb.incumbent();
+  int value = 0, weight = 0;
+  for(size_t i = 0; i < k.values.size(); ++i)
+  {
+    if(n.taken >> i & 01)
+    {
+      value += k.values[i];
+      weight += k.weights[i];
+    }
+  }
+  assert(value == n.value && weight == n.weight && weight <= k.capacity);
+  assert(value == optimum(k) && bb.incumbentBound() == -value);
+}
+
+/**
+ *  @brief test that every overflow policy finds the optimum, and that the
+ *  capped searches keep the open list within the cap.
+ */
+static void testPolicies()
+{
+  for(int round = 0; round < 04; ++round)
+  {
+    Knapsack k = instance(0x18);
+    BranchAndBound<Knapsack> unbounded(k);
+    checkSolved(unbounded, k);
+    assert(unbounded.statistics().dived == 0);
+    assert(unbounded.statistics().spilled == 0);
+
+    BranchAndBound<Knapsack> dive(k, 0x10);
+    checkSolved(dive, k);
+    assert(dive.statistics().peakOpen <= 0x10);
+
+    BranchAndBound<Knapsack> spill(k, 0x10,
+      BranchAndBound<Knapsack>::spillToDisk);
+    checkSolved(spill, k);
+    assert(spill.statistics().peakOpen <= 0x10);
+    assert(spill.statistics().dived == 0);
+    checkSolved(spill, k);
+
+    if(unbounded.statistics().peakOpen > 0x10)
+    {
+      assert(dive.statistics().dived != 0);
+      assert(spill.statistics().spilled != 0);
+    }
+  }
+}
+
+/**
+ *  @brief test pure depth-first search and incumbent pruning on an instance
+ *  small enough to count, and that spilling refuses nodes it cannot copy.
+ */
+static void testEdges()
+{
+  Knapsack k = instance(010);
+  BranchAndBound<Knapsack> dfs(k, 0);
+  checkSolved(dfs, k);
+  assert(dfs.statistics().peakOpen == 0);
+  assert(dfs.statistics().improved >= 01 && dfs.statistics().pruned != 0);
+
+  Knapsack none = k;
+  none.capacity = 0;
+  BranchAndBound<Knapsack> empty(none);
+  Knapsack::Node root = {0, 0, 0, 0};
+  assert(empty.solve(root) && empty.incumbent().taken == 0);
+
+  Lists lists;
+  bool threw = false;
+  try
+  {
+    BranchAndBound<Lists> bb(lists, 04, BranchAndBound<Lists>::spillToDisk);
+  }
+  catch(const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+  BranchAndBound<Lists> bb(lists);
+  assert(bb.solve(vector<int>(03)) && bb.incumbentBound() == 03);
+}
+
+int main()
+{
+  testPolicies();
+  testEdges();
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+
+template <class T>
+class tester;
+#define TEST friend class tester<T>
+#include "chunked_storage.h"
+#include "priority_queue.h"
+
+using namespace std;
+
+typedef ChunkedStorage<int, 0x40> Storage;
+typedef PriorityQueue<int, Identity<int>,
+  PriorityQueueTuning<sizeof(int)>, Storage> Queue;
+
+template <class T>
+class tester
+{
+  public:
+  static const Storage &storage(const Queue &q) { return q.heap; }
+};
+
+/**
+ *  @brief test that a PriorityQueue over ChunkedStorage sorts like one over
+ *  std::vector.
+ */
+static void testSorted()
+{
+  Queue q;
+  vector<int> v;
+  for(int i = 0; i < 0x1000; ++i)
+  {
+    int t = rand();
+    v.push_back(t);
+    q.insert(t);
+  }
+  sort(v.begin(), v.end());
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    assert(q.removeMin() == v[i]);
+  }
+  assert(q.size() == 0);
+}
+
+/**
+ *  @brief test that copies are independent and that a diverging copy only
+ *  unshares the chunks on its sift paths.
+ */
+static void testCopyOnWrite()
+{
+  Queue q;
+  for(int i = 0; i < 0x1000; ++i)
+  {
+    q.insert(rand());
+  }
+  const size_t chunks = (0x1000 + 01 + 0x3f) / 0x40;
+  assert(tester<int>::storage(q).sharedChunks() == 0);
+
+  Queue fork = q;
+  assert(tester<int>::storage(q).sharedChunks() == chunks);
+
+  int forkMin = fork.removeMin();
+  fork.insert(forkMin - 1);
+  //a sift path touches one chunk per level below the first chunk at most
+  assert(tester<int>::storage(q).sharedChunks() + 0x10 >= chunks);
+
+  assert(q.min() == forkMin && fork.min() == forkMin - 1);
+  assert(q.size() == 0x1000 && fork.size() == 0x1000);
+  q.removeMin();
+  assert(fork.removeMin() == forkMin - 1);
+  while(q.size() != 0)
+  {
+    assert(q.removeMin() == fork.removeMin());
+  }
+}
+
+int main(void)
+{
+  testSorted();
+  testCopyOnWrite();
+}
@@ -0,0 +1,95 @@
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "concurrent_queue.h"
+
+using namespace std;
+
+/**
+ *  Entry wide enough to span several snapshot words, carrying its key twice
+ *  so a torn read is detectable.
+ */
+struct Entry
+{
+  long key;
+  long pad[2];
+  long check;
+  bool operator<(const Entry &o) const { return key < o.key; }
+};
+
+static Entry make(long key)
+{
+  Entry e = {key, {0, 0}, -key};
+  return e;
+}
+
+/**
+ *  @brief test that peekMin() follows the minimum through inserts and
+ *  removals, including an empty queue.
+ */
+static void testSequential()
+{
+  ConcurrentPriorityQueue<Entry> q;
+  Entry e;
+  assert(!q.peekMin(e) && q.size() == 0);
+
+  q.insert(make(5));
+  assert(q.peekMin(e) && e.key == 5);
+  q.insert(make(9));
+  assert(q.peekMin(e) && e.key == 5 && q.size() == 2);
+  q.insert(make(2));
+  assert(q.peekMin(e) && e.key == 2);
+
+  assert(q.tryRemoveMin(e) && e.key == 2);
+  assert(q.peekMin(e) && e.key == 5);
+  assert(q.tryRemoveMin(e) && q.tryRemoveMin(e) && e.key == 9);
+  assert(!q.peekMin(e) && !q.tryRemoveMin(e));
+}
+
+/**
+ *  @brief test that readers polling peekMin() while a writer churns the
+ *  queue never observe a torn entry.
+ */
+static void testNoTearing()
+{
+  ConcurrentPriorityQueue<Entry> q;
+  atomic<bool> done(false);
+  vector<thread> readers;
+  for(int r = 0; r < 3; ++r)
+  {
+    readers.push_back(thread([&q, &done]()
+    {
+      Entry e;
+      while(!done.load())
+      {
+        if(q.peekMin(e))
+        {
+          assert(e.check == -e.key);
+        }
+      }
+    }));
+  }
+
+  Entry e;
+  for(long i = 0; i < 0x10000; ++i)
+  {
+    q.insert(make(rand()));
+    if(i & 01)
+    {
+      assert(q.tryRemoveMin(e) && e.check == -e.key);
+    }
+  }
+  done.store(true);
+  for(size_t r = 0; r < readers.size(); ++r)
+  {
+    readers[r].join();
+  }
+}
+
+int main(void)
+{
+  testSequential();
+  testNoTearing();
+}
@@ -0,0 +1,124 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "delay_queue.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ *  Clock that only moves when a test advances it.
+ */
+struct ManualClock
+{
+  typedef milliseconds duration;
+  typedef duration::rep rep;
+  typedef duration::period period;
+  typedef std::chrono::time_point<ManualClock> time_point;
+  static const bool is_steady = false;
+  static atomic<long> ticks;
+  static time_point now() { return time_point(duration(ticks.load())); }
+};
+atomic<long> ManualClock::ticks(0);
+
+/**
+ *  @brief test that entries only become available at their deadline, in
+ *  deadline then insertion order.
+ */
+static void testOrdering()
+{
+  typedef ManualClock::time_point at;
+  DelayQueue<int, ManualClock> q;
+  int out;
+  q.push(3, at(milliseconds(30)));
+  q.push(1, at(milliseconds(10)));
+  q.push(2, at(milliseconds(10)));
+  assert(q.size() == 3 && !q.tryTake(out));
+
+  ManualClock::ticks = 10;
+  assert(q.tryTake(out) && out == 1);
+  assert(q.tryTake(out) && out == 2);
+  assert(!q.tryTake(out));
+  ManualClock::ticks = 30;
+  assert(q.take() == 3 && q.size() == 0);
+}
+
+/**
+ *  @brief test that a consumer sleeping on the manual clock is released by
+ *  clockChanged() once the clock passes the deadline.
+ */
+static void testManualWake()
+{
+  typedef ManualClock::time_point at;
+  ManualClock::ticks = 0;
+  DelayQueue<int, ManualClock> q;
+  q.push(5, at(seconds(1000)));
+  atomic<int> got(0);
+  thread consumer([&q, &got]() { got = q.take(); });
+
+  this_thread::sleep_for(milliseconds(10));
+  assert(got == 0);
+  ManualClock::ticks = 1000 * 1000;
+  q.clockChanged();
+  consumer.join();
+  assert(got == 5);
+}
+
+/**
+ *  @brief test that an earlier entry pushed while a consumer sleeps on a
+ *  distant deadline wakes it early.
+ */
+static void testEarlyWake()
+{
+  DelayQueue<int> q;
+  steady_clock::time_point start = steady_clock::now();
+  q.push(1, start + seconds(30));
+  atomic<int> got(0);
+  thread consumer([&q, &got]() { got = q.take(); });
+
+  this_thread::sleep_for(milliseconds(10));
+  q.push(2, steady_clock::now() + milliseconds(10));
+  consumer.join();
+  assert(got == 2 && steady_clock::now() - start < seconds(10));
+  assert(q.size() == 1);
+}
+
+/**
+ *  @brief test that several consumers drain entries expiring together.
+ */
+static void testConsumers()
+{
+  DelayQueue<int> q;
+  steady_clock::time_point at = steady_clock::now() + milliseconds(20);
+  atomic<int> sum(0);
+  vector<thread> threads;
+  for(int c = 0; c < 4; ++c)
+  {
+    threads.push_back(thread([&q, &sum]()
+    {
+      for(int i = 0; i < 0x10; ++i)
+      {
+        sum += q.take();
+      }
+    }));
+  }
+  for(int i = 1; i <= 0x40; ++i)
+  {
+    q.push(i, at + milliseconds(i % 3));
+  }
+  for(size_t c = 0; c < threads.size(); ++c)
+  {
+    threads[c].join();
+  }
+  assert(sum == 0x40 * 0x41 / 2 && q.size() == 0);
+}
+
+int main(void)
+{
+  testOrdering();
+  testManualWake();
+  testEarlyWake();
+  testConsumers();
+}
@@ -0,0 +1,104 @@
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include "delta_stepping.h"
+
+using namespace std;
+
+/**
+ *  @brief Make a random graph with integer weights, so distances are exact
+ *  whatever order they are summed in. Vertex n - 1 has no edges and is
+ *  reached only if some other vertex points to it.
+ */
+static Graph randomGraph(unsigned n, size_t degree, unsigned maxWeight)
+{
+  Graph g;
+  for(unsigned v = 0; v < n; ++v)
+  {
+    g.offsets.push_back(g.targets.size());
+    for(size_t i = 0; v != n - 01 && i < degree; ++i)
+    {
+      g.targets.push_back(rand() % (n - 01));
+      g.weights.push_back(rand() % (maxWeight + 01));
+    }
+  }
+  g.offsets.push_back(g.targets.size());
+  return g;
+}
+
+/**
+ *  @brief test that delta-stepping matches Dijkstra for a range of deltas
+ *  and thread counts, including zero weight edges and unreachable vertices.
+ */
+static void testAgainstDijkstra()
+{
+  Graph g = randomGraph(0x1000, 04, 0x20);
+  vector<double> expected, got;
+  dijkstra(g, 0, expected);
+  assert(expected[0] == 0 && isinf(expected.back()));
+
+  const double deltas[] = {0.5, 1, 8, 0x20, 0x1000};
+  const size_t threads[] = {01, 02, 07};
+  for(size_t d = 0; d < sizeof(deltas) / sizeof(*deltas); ++d)
+  {
+    for(size_t t = 0; t < sizeof(threads) / sizeof(*threads); ++t)
+    {
+      DeltaStepping(g, deltas[d], threads[t]).run(0, got);
+      assert(got == expected);
+    }
+  }
+}
+
+/**
+ *  @brief test a path whose heavy edges must be relaxed after the light
+ *  ones of the same bucket.
+ */
+static void testLightAndHeavy()
+{
+  Graph g;
+  // 0 -> 1 heavy (10), 0 -> 2 light (1), 2 -> 1 light (1), 1 -> 3 heavy (10)
+  unsigned targets[] = {1, 2, 3, 1};
+  float weights[] = {10, 1, 10, 1};
+  size_t offsets[] = {0, 2, 3, 4, 4};
+  g.offsets.assign(offsets, offsets + 5);
+  g.targets.assign(targets, targets + 4);
+  g.weights.assign(weights, weights + 4);
+  vector<double> got;
+  DeltaStepping(g, 2, 02).run(0, got);
+  assert(got[0] == 0 && got[1] == 2 && got[2] == 1 && got[3] == 12);
+}
+
+/**
+ *  @brief test that a delta far below the weights, which would need
+ *  millions of buckets per thread, is rejected, and that one whose distances
+ *  run through many times more buckets than there are slots still matches
+ *  Dijkstra.
+ */
+static void testSlots()
+{
+  Graph g = randomGraph(0x400, 02, 0x20);
+  vector<double> expected, got;
+  dijkstra(g, 0, expected);
+  DeltaStepping(g, 0.125, 03).run(0, got);
+  assert(got == expected);
+
+  bool threw = false;
+  try
+  {
+    DeltaStepping(g, 1e-9, 01);
+  }
+  catch(const std::invalid_argument &)
+  {
+    threw = true;
+  }
+  assert(threw);
+}
+
+int main()
+{
+  testAgainstDijkstra();
+  testLightAndHeavy();
+  testSlots();
+}
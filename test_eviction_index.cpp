@@ -0,0 +1,113 @@
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+#include "eviction_index.h"
+
+using namespace std;
+
+/**
+ *  @brief test that evictions follow priorities including lazy bumps, and
+ *  that reprioritize() and erase() take effect.
+ */
+static void testEvict()
+{
+  EvictionIndex index;
+  unsigned slot;
+  assert(!index.evict(slot));
+  for(unsigned s = 0; s < 010; ++s)
+  {
+    index.insert(s, s);
+  }
+  index.touch(0, 0x10);
+  index.touch(01);
+  index.touch(01);
+  assert(index.priorityOf(0) == 0x10 && index.priorityOf(01) == 03);
+  index.reprioritize(07, 0);
+  index.erase(02);
+  assert(index.size() == 07 && !index.contains(02));
+
+  assert(index.evict(slot) && slot == 07);
+  unsigned tied;
+  assert(index.evict(slot) && index.evict(tied));
+  assert(slot + tied == 04 && (slot == 01 || slot == 03));
+  const unsigned rest[] = {04, 05, 06, 0};
+  for(size_t i = 0; i < 04; ++i)
+  {
+    assert(index.evict(slot) && slot == rest[i]);
+  }
+  assert(!index.evict(slot) && index.size() == 0);
+}
+
+/**
+ *  @brief test that bumps saturate instead of wrapping around.
+ */
+static void testSaturation()
+{
+  EvictionIndex index;
+  index.insert(0, EvictionIndex::never - 01);
+  index.insert(01, 05);
+  index.touch(0, 010);
+  index.touch(0, EvictionIndex::never);
+  assert(index.priorityOf(0) == EvictionIndex::never);
+  unsigned slot;
+  assert(index.evict(slot) && slot == 01);
+  assert(index.evict(slot) && slot == 0);
+}
+
+/**
+ *  @brief test expiry by deadline, slots without one never expiring, and
+ *  that expired slots are no longer evictable.
+ */
+static void testExpire()
+{
+  EvictionIndex index;
+  index.insert(0, 0, 30);
+  index.insert(01, 0);
+  index.insert(02, 0, 10);
+  index.insert(03, 0, 20);
+  vector<unsigned> out;
+  assert(index.expire(05, out) == 0);
+  assert(index.expire(20, out) == 02);
+  assert(out[0] == 02 && out[01] == 03);
+  assert(index.size() == 02 && !index.contains(03));
+  index.erase(0);
+  assert(index.expire(~0u - 01, out) == 0 && index.size() == 01);
+  unsigned slot;
+  assert(index.evict(slot) && slot == 01);
+}
+
+/**
+ *  @brief test that churn does not grow memory, which stays at 28 bytes per
+ *  preallocated slot.
+ */
+static void testMemory()
+{
+  static const unsigned slots = 0x10000;
+  EvictionIndex index(slots);
+  size_t before = index.memoryUsage();
+  assert(before == 28 * slots + 02 * sizeof(unsigned));
+  for(unsigned s = 0; s < slots; ++s)
+  {
+    unsigned expires = rand() % 02 ? 1000 + s : EvictionIndex::never;
+    index.insert(s, rand() % 0x100, expires);
+  }
+  unsigned slot;
+  for(int i = 0; i < 0x100000; ++i)
+  {
+    index.touch(rand() % slots);
+    if(i % 010 == 0)
+    {
+      assert(index.evict(slot));
+      index.insert(slot, 0, 1000 + i);
+    }
+  }
+  assert(index.memoryUsage() == before);
+}
+
+int main()
+{
+  testEvict();
+  testSaturation();
+  testExpire();
+  testMemory();
+}
@@ -0,0 +1,108 @@
+#include <cassert>
+#include <cstdlib>
+#include <set>
+#include <utility>
+#include <vector>
+#include "indexed_heap.h"
+
+using namespace std;
+
+/**
+ *  Priority projects an id to its entry in a shared array.
+ */
+struct Priority
+{
+  const vector<int> *values;
+  int operator()(unsigned id) const { return (*values)[id]; }
+};
+
+/**
+ *  @brief test random pushes, pops, erases and priority changes in both
+ *  directions against a std::set of (priority, id) pairs.
+ */
+template <class Tuning>
+static void testAgainstSet()
+{
+  static const unsigned ids = 0x400;
+  vector<int> priority(ids);
+  Priority key = {&priority};
+  IndexedHeap<Priority, Tuning> q(key);
+  set<pair<int, unsigned> > ref;
+  for(int step = 0; step < 0x10000; ++step)
+  {
+    unsigned id = rand() % ids;
+    int op = rand() % 04;
+    if(!q.contains(id))
+    {
+      priority[id] = rand() % 0x100;
+      q.push(id);
+      ref.insert(make_pair(priority[id], id));
+    }
+    else if(op == 0)
+    {
+      q.erase(id);
+      ref.erase(make_pair(priority[id], id));
+    }
+    else if(op == 01)
+    {
+      ref.erase(make_pair(priority[id], id));
+      priority[id] = rand() % 0x100;
+      q.update(id);
+      ref.insert(make_pair(priority[id], id));
+    }
+    else if(op == 02)
+    {
+      unsigned top = q.pop();
+      assert(priority[top] == ref.begin()->first);
+      ref.erase(make_pair(priority[top], top));
+      assert(!q.contains(top));
+    }
+    assert(q.size() == ref.size());
+    assert(q.size() == 0 || priority[q.top()] == ref.begin()->first);
+  }
+}
+
+/**
+ *  Tuning of a 4-ary heap.
+ */
+struct Quaternary
+{
+  static const size_t arity = 04;
+  static const size_t prefetch = 0;
+};
+
+/**
+ *  @brief test that memory depends on the ids reserved, not on updates.
+ */
+static void testMemory()
+{
+  vector<int> priority(0x100, 0);
+  Priority key = {&priority};
+  IndexedHeap<Priority> q(key);
+  q.reserve(0x100);
+  size_t before = q.memoryUsage();
+  assert(before >= 02 * 0x100 * sizeof(unsigned));
+  for(unsigned id = 0; id < 0x100; ++id)
+  {
+    q.push(id);
+  }
+  for(int i = 0; i < 0x10000; ++i)
+  {
+    unsigned id = rand() % 0x100;
+    priority[id] = rand();
+    q.update(id);
+  }
+  assert(q.memoryUsage() == before);
+
+  q.clear();
+  assert(q.size() == 0 && !q.contains(0) && q.memoryUsage() == before);
+  q.push(07);
+  assert(q.size() == 01 && q.top() == 07);
+}
+
+int main()
+{
+  testAgainstSet<PriorityQueueTuning<sizeof(unsigned)> >();
+  testAgainstSet<Quaternary>();
+  testMemory();
+}
@@ -0,0 +1,191 @@
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "io_scheduler.h"
+
+using namespace std;
+
+static const size_t fileSize = 0x4000;
+
+/**
+ *  @brief byte expected at a file offset.
+ */
+static char at(size_t offset)
+{
+  return static_cast<char>(offset % 251);
+}
+
+/**
+ *  @brief create an unlinked temp file of fileSize known bytes.
+ */
+static int makeFile()
+{
+  char path[] = "/tmp/ioschedXXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  unlink(path);
+  vector<char> data(fileSize);
+  for(size_t i = 0; i < fileSize; ++i)
+  {
+    data[i] = at(i);
+  }
+  assert(write(fd, &data[0], fileSize) == static_cast<ssize_t>(fileSize));
+  return fd;
+}
+
+/**
+ *  @brief dispatch once and return the completed ids.
+ */
+static vector<unsigned long long> step(IoScheduler &s)
+{
+  vector<IoCompletion> done;
+  s.dispatch(done);
+  vector<unsigned long long> ids;
+  for(size_t i = 0; i < done.size(); ++i)
+  {
+    assert(done[i].result >= 0);
+    ids.push_back(done[i].id);
+  }
+  return ids;
+}
+
+/**
+ *  @brief test that adjacent and overlapping requests are served by one
+ *  read with the right bytes in every buffer, and that the end of the file
+ *  gives short reads.
+ */
+static void testCoalescing(int fd)
+{
+  IoScheduler s;
+  char a[100], b[100], c[150], d[0x100];
+  s.submit(fd, 200, 100, b);
+  s.submit(fd, 100, 100, a);
+  s.submit(fd, 250, 150, c);
+  s.submit(fd, fileSize - 0x80, 0x100, d);
+
+  vector<IoCompletion> done;
+  assert(s.dispatch(done) == 3 && s.size() == 1);
+  for(size_t i = 0; i < 100; ++i)
+  {
+    assert(a[i] == at(100 + i) && b[i] == at(200 + i));
+  }
+  for(size_t i = 0; i < 150; ++i)
+  {
+    assert(c[i] == at(250 + i));
+  }
+
+  assert(s.dispatch(done) == 1 && done.back().result == 0x80);
+  assert(d[0] == at(fileSize - 0x80));
+  assert(s.dispatch(done) == 0);
+}
+
+/**
+ *  @brief test that the coalescing limit splits reads.
+ */
+static void testCoalesceLimit(int fd)
+{
+  IoScheduler s(IoScheduler::CSCAN, 200);
+  char buf[4][100];
+  for(int i = 0; i < 4; ++i)
+  {
+    s.submit(fd, 100 * i, 100, buf[i]);
+  }
+  assert(step(s).size() == 2 && step(s).size() == 2 && s.size() == 0);
+}
+
+/**
+ *  @brief test that zero-length requests coalesce, alone or at the end of
+ *  a read, completing with 0 bytes.
+ */
+static void testZeroLength(int fd)
+{
+  IoScheduler s;
+  char a[100], none[01];
+  s.submit(fd, 300, 0, none);
+  s.submit(fd, 300, 0, none);
+  vector<IoCompletion> done;
+  assert(s.dispatch(done) == 2);
+  assert(done[0].result == 0 && done[01].result == 0);
+
+  s.submit(fd, 100, 100, a);
+  s.submit(fd, 200, 0, none);
+  done.clear();
+  assert(s.dispatch(done) == 2 && s.size() == 0);
+  assert(a[0] == at(100) && a[99] == at(199));
+  assert(done[0].result + done[01].result == 100);
+}
+
+/**
+ *  @brief test C-SCAN order: ascending, requests behind the head wait for
+ *  the next ascending sweep.
+ */
+static void testCScan(int fd)
+{
+  IoScheduler s(IoScheduler::CSCAN);
+  char buf[8][10];
+  unsigned long long r500 = s.submit(fd, 500, 10, buf[0]);
+  unsigned long long r100 = s.submit(fd, 100, 10, buf[1]);
+  unsigned long long r300 = s.submit(fd, 300, 10, buf[2]);
+  assert(step(s)[0] == r100);
+  assert(step(s)[0] == r300);
+
+  unsigned long long r50 = s.submit(fd, 50, 10, buf[3]);
+  unsigned long long r200 = s.submit(fd, 200, 10, buf[4]);
+  unsigned long long r700 = s.submit(fd, 700, 10, buf[5]);
+  assert(step(s)[0] == r500);
+  assert(step(s)[0] == r700);
+  assert(step(s)[0] == r50);
+  assert(step(s)[0] == r200);
+}
+
+/**
+ *  @brief test SCAN order: the sweep reverses at the end.
+ */
+static void testScan(int fd)
+{
+  IoScheduler s(IoScheduler::SCAN);
+  char buf[8][10];
+  unsigned long long r100 = s.submit(fd, 100, 10, buf[0]);
+  unsigned long long r500 = s.submit(fd, 500, 10, buf[1]);
+  assert(step(s)[0] == r100);
+
+  unsigned long long r50 = s.submit(fd, 50, 10, buf[2]);
+  unsigned long long r200 = s.submit(fd, 200, 10, buf[3]);
+  assert(step(s)[0] == r200);
+  assert(step(s)[0] == r500);
+  assert(step(s)[0] == r50);
+}
+
+/**
+ *  @brief test that a request behind the head is served out of order once
+ *  it exceeds the latency cap.
+ */
+static void testLatencyCap(int fd)
+{
+  IoScheduler s(IoScheduler::CSCAN, 01 << 20, chrono::milliseconds(10));
+  char buf[8][10];
+  s.submit(fd, 1000, 10, buf[0]);
+  step(s);
+  unsigned long long old = s.submit(fd, 10, 10, buf[1]);
+  s.submit(fd, 2000, 10, buf[2]);
+  s.submit(fd, 3000, 10, buf[3]);
+  this_thread::sleep_for(chrono::milliseconds(15));
+  assert(step(s)[0] == old);
+  assert(step(s).size() == 1 && step(s).size() == 1 && s.size() == 0);
+}
+
+int main(void)
+{
+  int fd = makeFile();
+  testCoalescing(fd);
+  testCoalesceLimit(fd);
+  testZeroLength(fd);
+  testCScan(fd);
+  testScan(fd);
+  testLatencyCap(fd);
+  close(fd);
+}
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "key_caching_queue.h"
+#include "priority_queue.h"
+
+using namespace std;
+
+/**
+ *  Job is an entry without an operator<, ordered by one of its fields.
+ */
+struct Job
+{
+  int id;
+  double deadline;
+};
+
+/**
+ *  @brief test ordering by a data member through memberKey().
+ */
+static void testMemberKey()
+{
+  PriorityQueue<Job, MemberKey<Job, double> > q(memberKey(&Job::deadline));
+  vector<double> v;
+  for(int i = 0; i < 0x400; ++i)
+  {
+    Job j = {i, rand() / (double)RAND_MAX};
+    v.push_back(j.deadline);
+    q.insert(j);
+  }
+  sort(v.begin(), v.end());
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    assert(q.removeMin().deadline == v[i]);
+  }
+}
+
+/**
+ *  @brief test ordering by a lambda, here reversing the order of ints.
+ */
+static void testLambda()
+{
+  auto negate = [](int x) { return -x; };
+  PriorityQueue<int, decltype(negate)> q(negate);
+  vector<int> v;
+  for(int i = 0; i < 0x400; ++i)
+  {
+    int t = rand();
+    v.push_back(t);
+    q.insert(t);
+  }
+  sort(v.rbegin(), v.rend());
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    assert(q.removeMin() == v[i]);
+  }
+}
+
+/**
+ *  Score is an expensive projection, a hash lookup, that counts its calls.
+ */
+struct Score
+{
+  const unordered_map<string, int> *scores;
+  size_t *calls;
+  int operator()(const string &name) const
+  {
+    ++*calls;
+    return scores->at(name);
+  }
+};
+
+/**
+ *  @brief test that KeyCachingQueue sorts by the projection and calls it
+ *  once per entry.
+ */
+static void testCachedKey()
+{
+  unordered_map<string, int> scores;
+  vector<int> v;
+  for(int i = 0; i < 0x400; ++i)
+  {
+    int t = rand();
+    scores[to_string(i)] = t;
+    v.push_back(t);
+  }
+  size_t calls = 0;
+  Score score = {&scores, &calls};
+  KeyCachingQueue<string, Score> q(score);
+  for(int i = 0; i < 0x400; ++i)
+  {
+    q.insert(to_string(i));
+  }
+  assert(calls == 0x400);
+
+  sort(v.begin(), v.end());
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    assert(q.minKey() == v[i]);
+    assert(scores[q.min()] == v[i]);
+    assert(scores[q.removeMin()] == v[i]);
+  }
+  assert(q.size() == 0);
+  assert(calls == 0x400);
+}
+
+/**
+ *  @brief test that an IndirectQueue of pointers orders them by their
+ *  objects' keys and keeps the order after the objects change.
+ */
+static void testIndirect()
+{
+  vector<Job> jobs(0x400);
+  IndirectQueue<Job, MemberKey<Job, double> > q(
+    indirect<Job>(memberKey(&Job::deadline)));
+  vector<double> v;
+  for(size_t i = 0; i < jobs.size(); ++i)
+  {
+    jobs[i].id = i;
+    jobs[i].deadline = rand() / (double)RAND_MAX;
+    v.push_back(jobs[i].deadline);
+    q.insert(&jobs[i]);
+  }
+  for(size_t i = 0; i < jobs.size(); ++i)
+  {
+    jobs[i].deadline = -1;
+  }
+
+  sort(v.begin(), v.end());
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    assert(q.minKey() == v[i]);
+    Job *j = q.removeMin();
+    assert(j >= &jobs.front() && j <= &jobs.back());
+  }
+  assert(q.size() == 0);
+}
+
+int main()
+{
+  testMemberKey();
+  testLambda();
+  testCachedKey();
+  testIndirect();
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+#include "knn.h"
+
+using namespace std;
+
+/**
+ *  @brief return the k nearest neighbours by computing every distance one
+ *  float at a time and sorting.
+ */
+static vector<Neighbor> reference(const vector<float> &vectors, size_t dim,
+  const float *query, size_t k, bool dot)
+{
+  vector<Neighbor> all;
+  for(size_t i = 0; i < vectors.size() / dim; ++i)
+  {
+    float sum = 0;
+    for(size_t j = 0; j < dim; ++j)
+    {
+      float a = query[j], b = vectors[i * dim + j];
+      sum += dot ? -a * b : (a - b) * (a - b);
+    }
+    Neighbor n = {sum, (unsigned)i};
+    all.push_back(n);
+  }
+  sort(all.begin(), all.end());
+  all.resize(min(k, all.size()));
+  return all;
+}
+
+/**
+ *  @brief test that a result matches the reference up to float rounding of
+ *  the vectorized sums.
+ */
+static void check(const vector<Neighbor> &got, const vector<Neighbor> &want)
+{
+  assert(got.size() == want.size());
+  for(size_t i = 0; i < got.size(); ++i)
+  {
+    float scale = max(1.0f, want[i].distance < 0 ? -want[i].distance :
+      want[i].distance);
+    float diff = got[i].distance - want[i].distance;
+    assert((diff < 0 ? -diff : diff) <= 1e-4f * scale);
+    assert(i == 0 || !(got[i] < got[i - 01]));
+  }
+}
+
+/**
+ *  @brief test both distances over dimensions that do and do not fill the
+ *  vector lanes, with one and several threads.
+ */
+static void testSearch()
+{
+  static const size_t dims[] = {01, 03, 0x10, 0x25, 0x80};
+  for(size_t d = 0; d < sizeof(dims) / sizeof(*dims); ++d)
+  {
+    size_t dim = dims[d], count = 0x300;
+    vector<float> vectors(count * dim), query(dim);
+    for(size_t i = 0; i < vectors.size(); ++i)
+    {
+      vectors[i] = (rand() % 0x400) / 64.0f;
+    }
+    for(size_t i = 0; i < dim; ++i)
+    {
+      query[i] = (rand() % 0x400) / 64.0f;
+    }
+    KnnIndex<> l2(vectors.data(), count, dim);
+    KnnIndex<NegativeDot> ip(vectors.data(), count, dim);
+    vector<Neighbor> one, many;
+    l2.search(query.data(), 0x10, one);
+    check(one, reference(vectors, dim, query.data(), 0x10, false));
+    l2.search(query.data(), 0x10, many, 04);
+    assert(many.size() == one.size());
+    for(size_t i = 0; i < one.size(); ++i)
+    {
+      assert(many[i].id == one[i].id && many[i].distance == one[i].distance);
+    }
+    ip.search(query.data(), 05, one, 03);
+    check(one, reference(vectors, dim, query.data(), 05, true));
+  }
+}
+
+/**
+ *  @brief test that k beyond the number of vectors returns them all, and
+ *  that ties are broken by id.
+ */
+static void testEdges()
+{
+  vector<float> vectors(0x20, 1.0f);
+  float query[02] = {1.0f, 1.0f};
+  KnnIndex<> index(vectors.data(), 0x10, 02);
+  vector<Neighbor> out;
+  index.search(query, 0x40, out, 0x20);
+  assert(out.size() == 0x10);
+  for(unsigned i = 0; i < out.size(); ++i)
+  {
+    assert(out[i].id == i && out[i].distance == 0);
+  }
+  index.search(query, 03, out, 0);
+  assert(out.size() == 03 && out[0].id == 0 && out[02].id == 02);
+  KnnIndex<> empty(NULL, 0, 02);
+  empty.search(query, 03, out, 04);
+  assert(out.empty());
+}
+
+int main()
+{
+  testSearch();
+  testEdges();
+}
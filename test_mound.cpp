@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "mound.h"
+
+using namespace std;
+
+/**
+ *  @brief test that a single thread gets entries back sorted, including
+ *  duplicates, and that the mound grows levels as it fills.
+ */
+static void testSorted()
+{
+  Mound<long> q;
+  vector<long> v;
+  long out;
+  assert(!q.tryRemoveMin(out) && q.size() == 0);
+  for(int i = 0; i < 0x4000; ++i)
+  {
+    long t = rand() % 0x1000;
+    v.push_back(t);
+    q.insert(t);
+  }
+  assert(q.size() == v.size());
+  sort(v.begin(), v.end());
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    assert(q.tryRemoveMin(out) && out == v[i]);
+  }
+  assert(!q.tryRemoveMin(out) && q.size() == 0);
+}
+
+/**
+ *  @brief test that concurrent inserts and removals lose and duplicate
+ *  nothing, and leave a valid mound behind.
+ */
+static void testConcurrent()
+{
+  static const int threads = 4;
+  static const long each = 0x4000;
+  Mound<long> q;
+  vector<vector<long> > removed(threads);
+  vector<thread> pool;
+  for(int t = 0; t < threads; ++t)
+  {
+    pool.push_back(thread([&q, &removed, t]()
+    {
+      long out;
+      for(long i = 0; i < each; ++i)
+      {
+        q.insert(i * threads + t);
+        if(i & 01 && q.tryRemoveMin(out))
+        {
+          removed[t].push_back(out);
+        }
+      }
+    }));
+  }
+  for(int t = 0; t < threads; ++t)
+  {
+    pool[t].join();
+  }
+
+  vector<long> all;
+  for(int t = 0; t < threads; ++t)
+  {
+    all.insert(all.end(), removed[t].begin(), removed[t].end());
+  }
+  assert(q.size() == threads * each - all.size());
+  long out;
+  long last = -01;
+  while(q.tryRemoveMin(out))
+  {
+    assert(out >= last);
+    last = out;
+    all.push_back(out);
+  }
+  sort(all.begin(), all.end());
+  assert(all.size() == (size_t)(threads * each));
+  for(size_t i = 0; i < all.size(); ++i)
+  {
+    assert(all[i] == (long)i);
+  }
+}
+
+int main()
+{
+  testSorted();
+  testConcurrent();
+}
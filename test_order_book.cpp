@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "order_book.h"
+
+using namespace std;
+
+static size_t allocations = 0;
+
+/**
+ *  @brief count every allocation, to check the book makes none.
+ */
+void *operator new(size_t n)
+{
+  ++allocations;
+  if(void *p = malloc(n ? n : 01))
+  {
+    return p;
+  }
+  throw bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+  free(p);
+}
+
+/**
+ *  Fill is one reported trade.
+ */
+struct Fill
+{
+  unsigned maker;
+  OrderBook::Price price;
+  OrderBook::Quantity quantity;
+};
+
+/**
+ *  Resting is an order of the reference book.
+ */
+struct Resting
+{
+  unsigned id;
+  OrderBook::Side side;
+  OrderBook::Price price;
+  OrderBook::Quantity quantity;
+};
+
+/**
+ *  @brief match an order against a reference book kept in arrival order,
+ *  scanning it for the best price each fill.
+ */
+static OrderBook::Quantity referenceSubmit(vector<Resting> &book,
+  unsigned id, OrderBook::Side side, OrderBook::Price limit,
+  OrderBook::Quantity quantity, vector<Fill> &fills)
+{
+  while(quantity != 0)
+  {
+    size_t best = book.size();
+    for(size_t i = 0; i < book.size(); ++i)
+    {
+      if(book[i].side == side)
+      {
+        continue;
+      }
+      bool crosses = side == OrderBook::buy ? book[i].price <= limit :
+        book[i].price >= limit;
+      bool better = best == book.size() || (side == OrderBook::buy ?
+        book[i].price < book[best].price : book[i].price > book[best].price);
+      if(crosses && better)
+      {
+        best = i;
+      }
+    }
+    if(best == book.size())
+    {
+      break;
+    }
+    OrderBook::Quantity q = min(quantity, book[best].quantity);
+    Fill f = {book[best].id, book[best].price, q};
+    fills.push_back(f);
+    quantity -= q;
+    if((book[best].quantity -= q) == 0)
+    {
+      book.erase(book.begin() + best);
+    }
+  }
+  if(quantity != 0)
+  {
+    Resting r = {id, side, limit, quantity};
+    book.push_back(r);
+  }
+  return quantity;
+}
+
+/**
+ *  @brief test random submits and cancels against the reference book,
+ *  comparing fills, resting quantities and levels.
+ */
+static void testAgainstReference()
+{
+  static const unsigned ids = 0x100;
+  OrderBook book(ids, 0x50, 0x70);
+  vector<Resting> ref;
+  vector<unsigned> freeIds;
+  for(unsigned i = 0; i < ids; ++i)
+  {
+    freeIds.push_back(i);
+  }
+  for(int step = 0; step < 0x4000; ++step)
+  {
+    if(!ref.empty() && rand() % 02)
+    {
+      size_t i = rand() % ref.size();
+      unsigned id = ref[i].id;
+      assert(book.contains(id) && book.quantityOf(id) == ref[i].quantity);
+      book.cancel(id);
+      assert(!book.contains(id));
+      ref.erase(ref.begin() + i);
+      freeIds.push_back(id);
+    }
+    else if(!freeIds.empty())
+    {
+      unsigned id = freeIds.back();
+      freeIds.pop_back();
+      OrderBook::Side side = rand() % 02 ? OrderBook::buy : OrderBook::sell;
+      OrderBook::Price price = 0x60 + rand() % 0x11 - 010;
+      OrderBook::Quantity quantity = rand() % 0x20 + 01;
+      vector<Fill> want, got;
+      OrderBook::Quantity rested = referenceSubmit(ref, id, side, price,
+        quantity, want);
+      assert(book.submit(id, side, price, quantity,
+        [&got](unsigned maker, OrderBook::Price p, OrderBook::Quantity q)
+        {
+          Fill f = {maker, p, q};
+          got.push_back(f);
+        }) == rested);
+      assert(got.size() == want.size());
+      for(size_t i = 0; i < got.size(); ++i)
+      {
+        assert(got[i].maker == want[i].maker && got[i].price ==
+          want[i].price && got[i].quantity == want[i].quantity);
+      }
+      for(size_t i = 0; i < got.size(); ++i)
+      {
+        if(!book.contains(got[i].maker))
+        {
+          freeIds.push_back(got[i].maker);
+        }
+      }
+      if(rested == 0)
+      {
+        freeIds.push_back(id);
+      }
+    }
+
+    assert(book.size() == ref.size());
+    for(int s = 0; s < 02; ++s)
+    {
+      OrderBook::Side side = (OrderBook::Side)s;
+      OrderBook::Level levels[04];
+      size_t n = book.depth(side, levels, 04);
+      size_t seen = 0;
+      for(OrderBook::Price p = side == OrderBook::buy ? 0x70 : 0x50;
+        p >= 0x50 && p <= 0x70; p += side == OrderBook::buy ? -01 : 01)
+      {
+        OrderBook::Quantity quantity = 0;
+        unsigned orders = 0;
+        for(size_t j = 0; j < ref.size(); ++j)
+        {
+          if(ref[j].side == side && ref[j].price == p)
+          {
+            quantity += ref[j].quantity;
+            ++orders;
+          }
+        }
+        OrderBook::Level l = book.level(side, p);
+        assert(l.quantity == quantity && l.orders == orders);
+        if(orders != 0 && seen < 04)
+        {
+          assert(seen < n && levels[seen].price == p);
+          assert(levels[seen].quantity == quantity);
+          ++seen;
+        }
+      }
+      assert(seen == n);
+      OrderBook::Level top = OrderBook::Level();
+      assert(book.best(side, top) == (n != 0));
+      assert(n == 0 || top.price == levels[0].price);
+    }
+  }
+}
+
+/**
+ *  @brief test that submitting, matching and cancelling never allocate
+ *  once the book is built.
+ */
+static void testNoAllocation()
+{
+  OrderBook book(0x1000, 0, 0x3ff);
+  size_t fills = 0;
+  size_t before = allocations;
+  for(unsigned id = 0; id < 0x1000; ++id)
+  {
+    if(book.contains(id ^ 01))
+    {
+      book.cancel(id ^ 01);
+    }
+    book.submit(id, id % 03 ? OrderBook::buy : OrderBook::sell,
+      0x200 + rand() % 0x40 - 0x20, rand() % 0x10 + 01,
+      [&fills](unsigned, OrderBook::Price, OrderBook::Quantity)
+      {
+        ++fills;
+      });
+  }
+  assert(allocations == before && fills != 0);
+}
+
+int main()
+{
+  testAgainstReference();
+  testNoAllocation();
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+#include "persistent_heap.h"
+#include "priority_queue.h"
+
+using namespace std;
+
+/**
+ *  @brief test that PersistentHeap orders entries like PriorityQueue.
+ */
+static void testSorted()
+{
+  PersistentHeap<int> h;
+  PriorityQueue<int> p;
+  for(int i = 0; i < 0x400; ++i)
+  {
+    int t = rand();
+    h.insert(t);
+    p.insert(t);
+    if(i % 3 == 0)
+    {
+      assert(h.removeMin() == p.removeMin());
+    }
+    assert(h.size() == p.size() && (h.size() == 0 || h.min() == p.min()));
+  }
+  while(p.size() != 0)
+  {
+    assert(h.removeMin() == p.removeMin());
+  }
+  assert(h.size() == 0);
+}
+
+/**
+ *  @brief test that copies are snapshots unaffected by later operations on
+ *  either side.
+ */
+static void testSnapshots()
+{
+  PersistentHeap<int> h;
+  for(int i = 0x100; i > 0; --i)
+  {
+    h.insert(i);
+  }
+  PersistentHeap<int> snap = h;
+  vector<PersistentHeap<int> > forks(8, h);
+
+  for(int i = 0; i < 0x80; ++i)
+  {
+    h.removeMin();
+  }
+  h.insert(-1);
+  for(size_t f = 0; f < forks.size(); ++f)
+  {
+    forks[f].insert(static_cast<int>(f) * 1000);
+  }
+
+  assert(snap.size() == 0x100 && snap.min() == 1);
+  assert(h.size() == 0x81 && h.min() == -1);
+  for(int i = 1; i <= 0x100; ++i)
+  {
+    assert(snap.removeMin() == i);
+  }
+  assert(forks[0].min() == 0 && forks[3].size() == 0x101);
+  h.removeMin();
+  assert(h.removeMin() == 0x81);
+}
+
+/**
+ *  @brief test that freeing a heap with a very long left spine does not
+ *  overflow the stack.
+ */
+static void testDeepRelease()
+{
+  for(int order = 0; order < 2; ++order)
+  {
+    PersistentHeap<int> h;
+    for(int i = 0; i < 01 << 20; ++i)
+    {
+      h.insert(order ? i : -i);
+    }
+    PersistentHeap<int> snap = h;
+    h.removeMin();
+  }
+}
+
+int main(void)
+{
+  testSorted();
+  testSnapshots();
+  testDeepRelease();
+}
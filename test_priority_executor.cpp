@@ -0,0 +1,150 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include "priority_executor.h"
+
+using namespace std;
+using namespace std::chrono;
+
+typedef PriorityExecutor::Task Task;
+
+static mutex orderLock;
+static vector<int> order;
+
+/**
+ *  @brief record a value once started.
+ */
+static Task record(int val)
+{
+  lock_guard<mutex> guard(orderLock);
+  order.push_back(val);
+  co_return;
+}
+
+/**
+ *  @brief block the only worker until released, so tasks queue up behind it.
+ */
+static Task gate(atomic<bool> &open)
+{
+  while(!open.load())
+  {
+    this_thread::yield();
+  }
+  co_return;
+}
+
+/**
+ *  @brief test that queued tasks start in priority order, ties in spawn
+ *  order.
+ */
+static void testPriorityOrder()
+{
+  order.clear();
+  atomic<bool> open(false);
+  {
+    PriorityExecutor ex(1, 1);
+    ex.spawn(gate(open), 0);
+    ex.spawn(record(3), 30);
+    ex.spawn(record(1), 10);
+    ex.spawn(record(2), 20);
+    ex.spawn(record(4), 20);
+    open = true;
+  }
+  assert(order.size() == 4);
+  assert(order[0] == 1 && order[1] == 2 && order[2] == 4 && order[3] == 3);
+}
+
+/**
+ *  @brief yield between two priorities, recording each step.
+ */
+static Task alternate(PriorityExecutor &ex, int id, int low, int high)
+{
+  for(int i = 0; i < 3; ++i)
+  {
+    {
+      lock_guard<mutex> guard(orderLock);
+      order.push_back(id);
+    }
+    co_await ex.yield(i % 2 ? high : low);
+  }
+}
+
+/**
+ *  @brief test that yield() requeues behind more urgent work.
+ */
+static void testYield()
+{
+  order.clear();
+  atomic<bool> open(false);
+  {
+    PriorityExecutor ex(1, 1);
+    ex.spawn(gate(open), 0);
+    ex.spawn(alternate(ex, 1, 5, 5), 1);
+    ex.spawn(record(2), 3);
+    open = true;
+  }
+  //1 runs, yields to 5, so 2 at priority 3 runs before it resumes
+  assert(order.size() == 4 && order[0] == 1 && order[1] == 2);
+}
+
+/**
+ *  @brief sleep then record the time slept.
+ */
+static Task sleeper(PriorityExecutor &ex, atomic<long> &slept)
+{
+  steady_clock::time_point start = steady_clock::now();
+  co_await ex.sleepUntil(start + milliseconds(20));
+  slept = duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+/**
+ *  @brief test that sleepUntil() resumes after the deadline.
+ */
+static void testSleep()
+{
+  atomic<long> slept(-1);
+  {
+    PriorityExecutor ex(2);
+    ex.spawn(sleeper(ex, slept), 0);
+  }
+  assert(slept >= 20);
+}
+
+/**
+ *  @brief count down a shared counter across many yields.
+ */
+static Task spin(PriorityExecutor &ex, atomic<long> &count, int priority)
+{
+  for(int i = 0; i < 0x40; ++i)
+  {
+    ++count;
+    co_await ex.yield(priority);
+  }
+}
+
+/**
+ *  @brief test many tasks on several workers with batched dequeue.
+ */
+static void testMany()
+{
+  atomic<long> count(0);
+  {
+    PriorityExecutor ex(4, 8);
+    for(int t = 0; t < 0x100; ++t)
+    {
+      ex.spawn(spin(ex, count, t % 7), t % 5);
+    }
+    ex.join();
+    assert(count == 0x100 * 0x40);
+  }
+}
+
+int main(void)
+{
+  testPriorityOrder();
+  testYield();
+  testSleep();
+  testMany();
+}
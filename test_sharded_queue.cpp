@@ -0,0 +1,124 @@
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "sharded_queue.h"
+
+using namespace std;
+
+/**
+ *  @brief write a file of a fake sysfs tree.
+ */
+static void put(const string &path, const string &text)
+{
+  ofstream(path.c_str()) << text;
+}
+
+/**
+ *  @brief test NumaTopology against a fake three node sysfs tree with a
+ *  sparse node number and an asymmetric distance table.
+ */
+static void testTopology(const string &root)
+{
+  NumaTopology t(root);
+  assert(t.nodes() == 3);
+  assert(t.id(0) == 0 && t.id(1) == 1 && t.id(2) == 3);
+  assert(t.cpusOf(0).size() == 2 && t.cpusOf(1).size() == 3);
+  assert(t.nodeOf(0) == 0 && t.nodeOf(4) == 1 && t.nodeOf(8) == 2);
+  assert(t.nodeOf(1000) == 0);
+
+  vector<size_t> order = t.byDistance(0);
+  assert(order.size() == 3 && order[0] == 0 && order[1] == 2 &&
+    order[2] == 1);
+}
+
+/**
+ *  @brief test that removal prefers the local shard and steals nearest
+ *  first.
+ */
+static void testStealing(const string &root)
+{
+  ShardedQueue<int> q((NumaTopology(root)));
+  assert(q.shardCount() == 3);
+
+  q.insert(5, 1);
+  q.insert(7, 2);
+  q.insert(9, 0);
+  q.insert(1, 1);
+  assert(q.size() == 4);
+
+  int out;
+  assert(q.tryRemoveMin(out, 0) && out == 9); //local
+  assert(q.tryRemoveMin(out, 0) && out == 7); //nearest remote
+  assert(q.tryRemoveMin(out, 0) && out == 1); //farthest remote
+  assert(q.tryRemoveMin(out, 1) && out == 5);
+  assert(!q.tryRemoveMin(out, 2));
+  assert(q.size() == 0);
+}
+
+/**
+ *  @brief test that a missing sysfs tree degrades to a single node, and
+ *  that concurrent producers and consumers neither lose nor duplicate
+ *  entries.
+ */
+static void testSingleNode()
+{
+  NumaTopology t("/nonexistent");
+  assert(t.nodes() == 1 && !t.cpusOf(0).empty());
+
+  ShardedQueue<int> q(t);
+  const int perThread = 0x1000;
+  vector<thread> threads;
+  vector<long> sums(4, 0);
+  for(int w = 0; w < 4; ++w)
+  {
+    threads.push_back(thread([&q, &sums, w, perThread]()
+    {
+      for(int i = 0; i < perThread; ++i)
+      {
+        q.insert(i);
+        int out;
+        if(q.tryRemoveMin(out))
+        {
+          sums[w] += out;
+        }
+      }
+    }));
+  }
+  for(size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i].join();
+  }
+  long total = sums[0] + sums[1] + sums[2] + sums[3];
+  int out;
+  while(q.tryRemoveMin(out))
+  {
+    total += out;
+  }
+  assert(total == 4L * perThread * (perThread - 1) / 2);
+}
+
+int main(void)
+{
+  char dir[] = "/tmp/numaXXXXXX";
+  assert(mkdtemp(dir));
+  string root = dir;
+  put(root + "/online", "0-1,3\n");
+  assert(system(("mkdir " + root + "/node0 " + root + "/node1 " + root +
+    "/node3").c_str()) == 0);
+  put(root + "/node0/cpulist", "0-1\n");
+  put(root + "/node1/cpulist", "2,4-5\n");
+  put(root + "/node3/cpulist", "8\n");
+  put(root + "/node0/distance", "10 30 20\n");
+  put(root + "/node1/distance", "30 10 20\n");
+  put(root + "/node3/distance", "20 20 10\n");
+
+  testTopology(root);
+  testStealing(root);
+  testSingleNode();
+
+  assert(system(("rm -r " + root).c_str()) == 0);
+}
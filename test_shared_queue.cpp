@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+template <class T>
+class tester;
+#define TEST friend class tester<T>
+#include "shared_queue.h"
+
+using namespace std;
+
+typedef SharedPriorityQueue<int> Queue;
+
+template <class T>
+class tester
+{
+  public:
+  static void lock(Queue &q) { q.lock(); }
+  static void scramble(Queue &q)
+  {
+    int *entries = q.mapping.entries();
+    reverse(entries + 01, entries + q.mapping.header->count);
+  }
+};
+
+/**
+ *  @brief return a segment name unique to this process and test.
+ */
+static string name(const char *test)
+{
+  char buf[0x40];
+  snprintf(buf, sizeof(buf), "/pq_test_%d_%s", (int)getpid(), test);
+  return buf;
+}
+
+/**
+ *  @brief wait for a child and check it exited cleanly.
+ */
+static void reap(pid_t pid)
+{
+  int status;
+  assert(waitpid(pid, &status, 0) == pid);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+/**
+ *  @brief test that entries pushed by several producer processes come out
+ *  of the parent in order, and that the capacity is enforced.
+ */
+static void testProducers()
+{
+  const string n = name("producers");
+  const int producers = 4, each = 0x100;
+  Queue q(n, producers * each);
+  assert(q.capacity() == (size_t)(producers * each));
+
+  vector<pid_t> children;
+  for(int p = 0; p < producers; ++p)
+  {
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+      Queue child(n, 0);
+      for(int i = 0; i < each; ++i)
+      {
+        child.push((i * 0x9e37 + p) % 0x10000);
+      }
+      _exit(0);
+    }
+    children.push_back(pid);
+  }
+  for(size_t i = 0; i < children.size(); ++i)
+  {
+    reap(children[i]);
+  }
+
+  assert(q.size() == (size_t)(producers * each));
+  assert(!q.push(0));
+  int prev = -1, out;
+  while(q.tryPop(out))
+  {
+    assert(out >= prev);
+    prev = out;
+  }
+  assert(q.size() == 0);
+  Queue::unlink(n);
+}
+
+/**
+ *  @brief test that a consumer process blocked on an empty queue is woken
+ *  by a push from another process.
+ */
+static void testBlockingPop()
+{
+  const string n = name("blocking");
+  Queue q(n, 0x10);
+  Queue result(n + "_result", 0x10);
+  pid_t pid = fork();
+  if(pid == 0)
+  {
+    Queue child(n, 0);
+    Queue reply(n + "_result", 0);
+    int a = child.pop();
+    int b = child.pop();
+    reply.push(a);
+    reply.push(b);
+    _exit(0);
+  }
+  usleep(20000);
+  q.push(5);
+  usleep(20000);
+  q.push(3);
+  reap(pid);
+  assert(result.pop() == 3 && result.pop() == 5);
+  Queue::unlink(n);
+  Queue::unlink(n + "_result");
+}
+
+/**
+ *  @brief test that a process dying with the lock held, after leaving the
+ *  heap out of order, does not wedge or corrupt the queue.
+ */
+static void testOwnerDied()
+{
+  const string n = name("died");
+  Queue q(n, 0x100);
+  for(int i = 0; i < 0x80; ++i)
+  {
+    q.push(i);
+  }
+  pid_t pid = fork();
+  if(pid == 0)
+  {
+    Queue child(n, 0);
+    tester<int>::lock(child);
+    tester<int>::scramble(child);
+    _exit(0);
+  }
+  reap(pid);
+
+  assert(q.size() == 0x80);
+  int out;
+  for(int i = 0; i < 0x80; ++i)
+  {
+    assert(q.tryPop(out) && out == i);
+  }
+  q.push(1);
+  assert(q.pop() == 1);
+  Queue::unlink(n);
+}
+
+/**
+ *  @brief return the errno a constructor attaching to a name throws, 0 if
+ *  it succeeds.
+ */
+static int attachError(const string &n)
+{
+  try
+  {
+    Queue q(n, 0);
+  }
+  catch(const std::system_error &e)
+  {
+    return e.code().value();
+  }
+  return 0;
+}
+
+/**
+ *  @brief test that a segment whose creator died before sizing it, or whose
+ *  array does not fit, is rejected instead of waited on or mapped.
+ */
+static void testBadSegment()
+{
+  const string n = name("bad");
+  int fd = shm_open(n.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  assert(fd >= 0);
+  assert(attachError(n) == ETIMEDOUT);
+  assert(ftruncate(fd, 0x40) == 0);
+  assert(attachError(n) == EINVAL);
+  close(fd);
+  Queue::unlink(n);
+
+  {
+    Queue q(n, 0x100);
+    fd = shm_open(n.c_str(), O_RDWR, 0);
+    assert(fd >= 0 && ftruncate(fd, 0x100) == 0);
+    close(fd);
+    assert(attachError(n) == EINVAL);
+  }
+  Queue::unlink(n);
+}
+
+int main()
+{
+  testProducers();
+  testBlockingPop();
+  testOwnerDied();
+  testBadSegment();
+}
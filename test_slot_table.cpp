@@ -0,0 +1,79 @@
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+#include "slot_table.h"
+
+using namespace std;
+
+/**
+ *  @brief test random inserts and erases against a plain array, with few
+ *  distinct hashes so probe runs are long and wrap around the table.
+ */
+static void testAgainstArray()
+{
+  const unsigned slots = 0x40;
+  SlotTable table(slots);
+  vector<unsigned> values(slots);
+  vector<bool> present(slots, false);
+  for(int step = 0; step < 0x10000; ++step)
+  {
+    unsigned s = rand() % slots;
+    if(present[s])
+    {
+      table.erase(values[s] % 0x0d * 0x11, s);
+      present[s] = false;
+    }
+    else
+    {
+      values[s] = rand() % 0x100;
+      table.insert(values[s] % 0x0d * 0x11, s);
+      present[s] = true;
+    }
+
+    unsigned v = rand() % 0x100;
+    unsigned found = table.find(v % 0x0d * 0x11, [&](unsigned slot)
+    {
+      return values[slot] == v;
+    });
+    if(found == SlotTable::absent)
+    {
+      for(unsigned t = 0; t < slots; ++t)
+      {
+        assert(!present[t] || values[t] != v);
+      }
+    }
+    else
+    {
+      assert(present[found] && values[found] == v);
+    }
+  }
+}
+
+/**
+ *  @brief test that clear() empties the table for reuse, and that a table
+ *  for no slots finds nothing.
+ */
+static void testClear()
+{
+  SlotTable table(04);
+  for(unsigned s = 0; s < 04; ++s)
+  {
+    table.insert(s, s);
+  }
+  table.clear();
+  for(unsigned s = 0; s < 04; ++s)
+  {
+    assert(table.find(s, [](unsigned) { return true; }) == SlotTable::absent);
+  }
+  table.insert(07, 02);
+  assert(table.find(07, [](unsigned) { return true; }) == 02);
+
+  SlotTable none(0);
+  assert(none.find(0, [](unsigned) { return true; }) == SlotTable::absent);
+}
+
+int main()
+{
+  testAgainstArray();
+  testClear();
+}
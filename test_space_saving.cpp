@@ -0,0 +1,120 @@
+#include <cassert>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+#include "space_saving.h"
+
+using namespace std;
+
+typedef SpaceSaving<unsigned> Summary;
+
+/**
+ *  @brief draw a skewed stream, item i about 1/(i+1) as often as item 0,
+ *  with ids shifted for odd seeds so shards share only some items.
+ */
+static vector<unsigned> stream(size_t n, unsigned seed)
+{
+  mt19937 gen(seed);
+  vector<unsigned> s;
+  for(size_t i = 0; i < n; ++i)
+  {
+    double u = (gen() + 0.5) / 4294967296.0;
+    s.push_back((unsigned)(1 / u) % 0x1000 + seed % 02 * 0x100);
+  }
+  return s;
+}
+
+/**
+ *  @brief test the Space-Saving guarantees against exact counts: every
+ *  count bounds its frequency within its error, every error is within N/k,
+ *  and every item more frequent than N/k is monitored.
+ */
+static void check(const Summary &summary, const map<unsigned, unsigned> &exact)
+{
+  unsigned long long n = summary.totalWeight();
+  unsigned long long bound = n / summary.capacity();
+  vector<Summary::Counter> top;
+  summary.top(top);
+  assert(top.size() == summary.size());
+  for(size_t i = 0; i < top.size(); ++i)
+  {
+    map<unsigned, unsigned>::const_iterator e = exact.find(top[i].item);
+    unsigned long long f = e == exact.end() ? 0 : e->second;
+    assert(top[i].count >= f && top[i].count - top[i].error <= f);
+    assert(top[i].error <= bound);
+    assert(i == 0 || top[i].count <= top[i - 01].count);
+  }
+  for(map<unsigned, unsigned>::const_iterator e = exact.begin();
+    e != exact.end(); ++e)
+  {
+    unsigned long long count, error;
+    bool found = summary.estimate(e->first, count, error);
+    assert(!(e->second > bound) || found);
+    assert(count >= e->second && count - error <= e->second);
+  }
+}
+
+/**
+ *  @brief test a single summary, weighted and not, and the empty cases.
+ */
+static void testSingle()
+{
+  vector<unsigned> s = stream(0x20000, 02);
+  Summary summary(0x40);
+  map<unsigned, unsigned> exact;
+  for(size_t i = 0; i < s.size(); ++i)
+  {
+    unsigned w = i % 03 + 01;
+    summary.offer(s[i], w);
+    exact[s[i]] += w;
+  }
+  assert(summary.size() == 0x40);
+  check(summary, exact);
+
+  Summary small(010);
+  unsigned long long count, error;
+  assert(!small.estimate(01, count, error) && count == 0);
+  small.offer(01);
+  small.offer(01);
+  assert(small.estimate(01, count, error) && count == 02 && error == 0);
+  Summary none(0);
+  none.offer(01);
+  assert(none.size() == 0 && none.totalWeight() == 0);
+  assert(!none.estimate(01, count, error) && count == 0 && error == 0);
+  Summary alsoNone(0);
+  none.merge(alsoNone);
+  assert(none.size() == 0);
+}
+
+/**
+ *  @brief test that merging shard summaries keeps the guarantees for the
+ *  whole stream, with shards sharing some items and not others.
+ */
+static void testMerge()
+{
+  Summary merged(0x40);
+  map<unsigned, unsigned> exact;
+  for(unsigned shard = 0; shard < 04; ++shard)
+  {
+    vector<unsigned> s = stream(0x8000, shard + 03);
+    Summary summary(0x40);
+    for(size_t i = 0; i < s.size(); ++i)
+    {
+      summary.offer(s[i]);
+      ++exact[s[i]];
+    }
+    merged.merge(summary);
+    assert(merged.totalWeight() == (shard + 01) * 0x8000ull);
+  }
+  check(merged, exact);
+  merged.offer(0x12345);
+  ++exact[0x12345];
+  check(merged, exact);
+}
+
+int main()
+{
+  testSingle();
+  testMerge();
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "string_prefix_queue.h"
+
+using namespace std;
+
+/**
+ *  @brief Make a random string over a small alphabet, so that prefixes
+ *  often tie and the full comparison is exercised.
+ */
+static string randomString()
+{
+  string s(rand() % 0x14, 'a');
+  for(size_t i = 0; i < s.size(); ++i)
+  {
+    s[i] = "ab\0\xff"[rand() % 04];
+  }
+  return s;
+}
+
+/**
+ *  @brief test that strings come out in std::string order, including ties
+ *  of the prefix, embedded NUL bytes and bytes above 0x7f.
+ */
+static void testSorted()
+{
+  StringPrefixQueue<> q;
+  vector<string> v;
+  for(int i = 0; i < 0x1000; ++i)
+  {
+    string s = randomString();
+    v.push_back(s);
+    q.insert(s);
+  }
+  sort(v.begin(), v.end());
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    assert(q.min() == v[i]);
+    assert(q.removeMin() == v[i]);
+  }
+  assert(q.size() == 0);
+}
+
+/**
+ *  Page is a string keyed record, ordered by its url.
+ */
+struct Page
+{
+  string url;
+  int depth;
+};
+
+/**
+ *  @brief test ordering records through a projection to their string key.
+ */
+static void testProjection()
+{
+  StringPrefixQueue<Page, MemberKey<Page, string> > q(
+    memberKey(&Page::url));
+  vector<string> v;
+  for(int i = 0; i < 0x400; ++i)
+  {
+    Page p = {randomString(), i};
+    v.push_back(p.url);
+    q.insert(p);
+  }
+  sort(v.begin(), v.end());
+  for(size_t i = 0; i < v.size(); ++i)
+  {
+    assert(q.removeMin().url == v[i]);
+  }
+}
+
+int main()
+{
+  testSorted();
+  testProjection();
+}
@@ -0,0 +1,160 @@
+#include <cassert>
+#include <chrono>
+#include <vector>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include "timer_queue.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ *  @brief Wait on an epoll set holding the timerfd.
+ *
+ *  @return whether the timerfd became readable within the timeout.
+ */
+static bool waitReadable(int epoll, int timeoutMs)
+{
+  epoll_event e;
+  return epoll_wait(epoll, &e, 01, timeoutMs) == 01;
+}
+
+/**
+ *  @brief test that the timerfd is only reprogrammed when the earliest
+ *  deadline changes.
+ */
+static void testReprogramOnRootChange()
+{
+  TimerQueue q;
+  TimerQueue::Clock::time_point now = TimerQueue::Clock::now();
+  q.add(now + seconds(10), []() {});
+  assert(q.reprograms() == 01);
+  q.add(now + seconds(20), []() {});
+  TimerQueue::Id later = q.add(now + seconds(30), []() {});
+  assert(q.reprograms() == 01);
+  TimerQueue::Id earliest = q.add(now + seconds(5), []() {});
+  assert(q.reprograms() == 02 && q.next() == now + seconds(5));
+
+  assert(q.cancel(later) && q.reprograms() == 02);
+  assert(!q.cancel(later));
+  assert(q.cancel(earliest) && q.reprograms() == 03);
+  assert(q.size() == 02 && q.next() == now + seconds(10));
+}
+
+/**
+ *  @brief test that epoll reports the timerfd once timers are due, and that
+ *  one fire() runs every due timer in deadline order.
+ */
+static void testEpollBatch()
+{
+  TimerQueue q;
+  int epoll = epoll_create1(EPOLL_CLOEXEC);
+  epoll_event e = {};
+  e.events = EPOLLIN;
+  assert(epoll_ctl(epoll, EPOLL_CTL_ADD, q.fd(), &e) == 0);
+
+  vector<int> fired;
+  TimerQueue::Clock::time_point now = TimerQueue::Clock::now();
+  for(int i = 0; i < 0x10; ++i)
+  {
+    q.add(now + milliseconds(20 + i % 04), [&fired, i]()
+    {
+      fired.push_back(i);
+    });
+  }
+  q.add(now + seconds(60), [&fired]() { fired.push_back(-01); });
+  assert(!waitReadable(epoll, 0));
+
+  assert(waitReadable(epoll, 5000));
+  while(TimerQueue::Clock::now() < now + milliseconds(24))
+  {
+    usleep(1000);
+  }
+  assert(q.fire() == 0x10);
+  assert(fired.size() == 0x10);
+  for(size_t i = 01; i < fired.size(); ++i)
+  {
+    assert(fired[i - 01] % 04 <= fired[i] % 04);
+  }
+  assert(q.size() == 01);
+  assert(!waitReadable(epoll, 10));
+  close(epoll);
+}
+
+/**
+ *  @brief test that callbacks may add and cancel timers, that a due timer
+ *  added by a callback is reported at once, and that stale ids are refused.
+ */
+static void testReentrant()
+{
+  TimerQueue q;
+  int epoll = epoll_create1(EPOLL_CLOEXEC);
+  epoll_event e = {};
+  e.events = EPOLLIN;
+  epoll_ctl(epoll, EPOLL_CTL_ADD, q.fd(), &e);
+
+  int runs = 0;
+  TimerQueue::Id self = 0;
+  TimerQueue::Id victim = q.add(TimerQueue::Clock::now() + seconds(60),
+    [&runs]() { runs += 0x100; });
+  self = q.add(TimerQueue::Clock::time_point(), [&]()
+  {
+    ++runs;
+    assert(!q.cancel(self));
+    assert(q.cancel(victim));
+    q.add(TimerQueue::Clock::time_point(), [&runs]() { ++runs; });
+  });
+  assert(waitReadable(epoll, 1000));
+  assert(q.fire() == 01 && runs == 01);
+  assert(waitReadable(epoll, 1000));
+  assert(q.fire() == 01 && runs == 02 && q.size() == 0);
+  assert(!q.cancel(self) && !q.cancel(victim));
+  close(epoll);
+}
+
+/**
+ *  @brief test that timers with overlapping slack windows are fired by a
+ *  handful of wakeups, never before their deadlines.
+ */
+static void testSlackCoalescing()
+{
+  TimerQueue q;
+  int epoll = epoll_create1(EPOLL_CLOEXEC);
+  epoll_event e = {};
+  e.events = EPOLLIN;
+  epoll_ctl(epoll, EPOLL_CTL_ADD, q.fd(), &e);
+
+  static const int timers = 0x1000;
+  TimerQueue::Clock::time_point start = TimerQueue::Clock::now();
+  int early = 0;
+  for(int i = 0; i < timers; ++i)
+  {
+    TimerQueue::Clock::time_point deadline = start + milliseconds(10) +
+      microseconds(100000 * i / timers);
+    q.add(deadline, milliseconds(50), [deadline, &early]()
+    {
+      early += TimerQueue::Clock::now() < deadline;
+    });
+  }
+  assert(q.next() == start + milliseconds(60));
+
+  int wakeups = 0;
+  int fired = 0;
+  while(q.size() != 0)
+  {
+    assert(waitReadable(epoll, 5000));
+    fired += q.fire();
+    ++wakeups;
+  }
+  assert(fired == timers && early == 0);
+  assert(wakeups <= 03);
+  close(epoll);
+}
+
+int main()
+{
+  testReprogramOnRootChange();
+  testEpollBatch();
+  testReentrant();
+  testSlackCoalescing();
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "weighted_reservoir.h"
+
+using namespace std;
+
+static const int trials = 0x4000;
+
+/**
+ *  @brief return how often each item is sampled, over independent runs of
+ *  a reservoir of size k, optionally split into two merged halves.
+ */
+static vector<double> inclusion(const vector<double> &weights, size_t k,
+  bool split)
+{
+  vector<double> count(weights.size(), 0);
+  for(int t = 0; t < trials; ++t)
+  {
+    WeightedReservoir<int> r(k, 02 * t), other(k, 02 * t + 01);
+    for(size_t i = 0; i < weights.size(); ++i)
+    {
+      (split && i % 02 ? other : r).offer(i, weights[i]);
+    }
+    r.merge(other);
+    vector<int> sample;
+    r.sample(sample);
+    assert(sample.size() == min(k, weights.size()));
+    for(size_t i = 0; i < sample.size(); ++i)
+    {
+      ++count[sample[i]];
+    }
+  }
+  for(size_t i = 0; i < count.size(); ++i)
+  {
+    count[i] /= trials;
+  }
+  return count;
+}
+
+/**
+ *  @brief return how often each item is sampled by A-Res computed
+ *  directly, one key per item.
+ */
+static vector<double> reference(const vector<double> &weights, size_t k)
+{
+  mt19937_64 gen(0);
+  uniform_real_distribution<double> u(0, 1);
+  vector<double> count(weights.size(), 0);
+  for(int t = 0; t < trials; ++t)
+  {
+    vector<pair<double, size_t> > keys;
+    for(size_t i = 0; i < weights.size(); ++i)
+    {
+      keys.push_back(make_pair(-pow(u(gen), 1 / weights[i]), i));
+    }
+    sort(keys.begin(), keys.end());
+    for(size_t i = 0; i < k; ++i)
+    {
+      ++count[keys[i].second];
+    }
+  }
+  for(size_t i = 0; i < count.size(); ++i)
+  {
+    count[i] /= trials;
+  }
+  return count;
+}
+
+/**
+ *  @brief test that a single draw picks items in proportion to weight,
+ *  with and without merging, and that weight 0 is never picked.
+ */
+static void testSingle()
+{
+  double w[] = {1, 2, 0, 3, 4};
+  vector<double> weights(w, w + sizeof(w) / sizeof(*w));
+  for(int split = 0; split < 02; ++split)
+  {
+    vector<double> p = inclusion(weights, 01, split);
+    for(size_t i = 0; i < weights.size(); ++i)
+    {
+      assert(fabs(p[i] - weights[i] / 10) < 0.02);
+    }
+  }
+}
+
+/**
+ *  @brief test that larger samples, including ones filled by skipping,
+ *  match A-Res computed directly.
+ */
+static void testAgainstReference()
+{
+  vector<double> weights;
+  for(int i = 0; i < 0x20; ++i)
+  {
+    weights.push_back(i % 05 + 0.25);
+  }
+  vector<double> want = reference(weights, 04);
+  for(int split = 0; split < 02; ++split)
+  {
+    vector<double> got = inclusion(weights, 04, split);
+    for(size_t i = 0; i < weights.size(); ++i)
+    {
+      assert(fabs(got[i] - want[i]) < 0.03);
+    }
+  }
+}
+
+/**
+ *  @brief test that a long stream mostly skips the heap.
+ */
+static void testSkipping()
+{
+  WeightedReservoir<unsigned> r(0x40, 07);
+  mt19937 gen(01);
+  for(unsigned i = 0; i < 01 << 20; ++i)
+  {
+    r.offer(i, gen() % 0x10 + 01);
+  }
+  assert(r.size() == 0x40);
+  assert(r.entries() < 0x40 * 020);
+  assert(r.totalWeight() > (01 << 20));
+}
+
+int main()
+{
+  testSingle();
+  testAgainstReference();
+  testSkipping();
+}
@@ -0,0 +1,132 @@
+#ifndef TIMER_QUEUE_H
+#define TIMER_QUEUE_H
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "indexed_heap.h"
+
+/**
+ *  TimerQueue class defines the timers of an event loop, backed by a Linux
+ *  timerfd so the loop sleeps in epoll until the earliest timer is due.
+ *
+ *  <p>
+ *  Timers are kept in an IndexedHeap by deadline. The timerfd is always
+ *  armed for the deadline at the root, and is reprogrammed only when the
+ *  root's deadline changes: adding a timer that is not the earliest, or
+ *  cancelling one that is not, costs no system call. The loop registers
+ *  fd() with epoll for reading and calls fire() when it becomes readable.
+ *  fire() pops every timer that is due, as one batch, then runs their
+ *  callbacks, so a burst of timers sharing a deadline costs one wakeup.
+ *  </p>
+ *
+ *  <p>
+ *  A timer may also allow slack: it must not run before its deadline nor
+ *  after deadline + slack, anywhere in between is fine. A second
+ *  IndexedHeap orders timers by that latest time, and the timerfd is armed
+ *  for the earliest latest time rather than the earliest deadline. The
+ *  wakeup then runs every timer whose deadline has passed, not only the
+ *  one that forced it. This is the greedy that stabs intervals at their
+ *  earliest right end, which uses the fewest wakeups that honour every
+ *  window. Timers added without slack are windows of width 0 and behave as
+ *  described above.
+ *  </p>
+ *
+ *  <p>
+ *  Deadlines are steady_clock time points, which is CLOCK_MONOTONIC on
+ *  Linux, and the timerfd is armed with absolute times on that clock, so
+ *  no time passes between reading the clock and arming. A TimerQueue is
+ *  used by its loop thread only. Callbacks may add and cancel timers,
+ *  including their own, which has already been removed when it runs.
+ *  </p>
+ *
+ *  Member Variables:\n
+ *    timer the timerfd, closed on destruction.
+ *    timers deadline, latest time, callback and generation of each slot.
+ *    unused indices of free slots.
+ *    queue IndexedHeap of pending slots by deadline.
+ *    byLatest IndexedHeap of pending slots by deadline + slack.
+ *    armed time the timerfd is programmed for, or the epoch if disarmed.
+ *    programmed number of times the timerfd was reprogrammed.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) create the timerfd, throws std::system_error on
+ *        failure.
+ *    - (Destructor) close the timerfd.
+ *    - fd() return the timerfd to register with epoll.
+ *    - size() return the number of pending timers.
+ *    - next() return the time of the next wakeup, the earliest latest time.
+ *    - add() add a timer, optionally with slack, and return its id.
+ *    - cancel() cancel a pending timer.
+ *    - fire() run every timer that is due.
+ *    - reprograms() return how often the timerfd was reprogrammed.
+ *    - arm() private helper program the timerfd for the next wakeup if it
+ *        moved.
+ *  </p>
+ */
+class TimerQueue
+{
+  public:
+    typedef std::chrono::steady_clock Clock;
+    typedef unsigned long long Id;
+    TimerQueue();
+    ~TimerQueue();
+    TimerQueue(const TimerQueue &) = delete;
+    TimerQueue &operator=(const TimerQueue &) = delete;
+    int fd() const noexcept;
+    size_t size() const noexcept;
+    Clock::time_point next() const noexcept;
+    Id add(Clock::time_point, std::function<void()>);
+    Id add(Clock::time_point, Clock::duration, std::function<void()>);
+    bool cancel(Id);
+    size_t fire();
+    unsigned long long reprograms() const noexcept;
+
+  private:
+    /**
+     *  Timer is one slot: a pending timer, or a free slot whose generation
+     *  tells stale ids apart.
+     */
+    struct Timer
+    {
+      Clock::time_point deadline;
+      Clock::time_point latest;
+      std::function<void()> callback;
+      unsigned generation;
+    };
+
+    /**
+     *  Deadline projects a slot to the deadline of its timer.
+     */
+    struct Deadline
+    {
+      const std::vector<Timer> *timers;
+      Clock::time_point operator()(unsigned slot) const noexcept
+      {
+        return (*timers)[slot].deadline;
+      }
+    };
+
+    /**
+     *  Latest projects a slot to the latest time its timer may run.
+     */
+    struct Latest
+    {
+      const std::vector<Timer> *timers;
+      Clock::time_point operator()(unsigned slot) const noexcept
+      {
+        return (*timers)[slot].latest;
+      }
+    };
+    void arm();
+    int timer;
+    std::vector<Timer> timers;
+    std::vector<unsigned> unused;
+    IndexedHeap<Deadline> queue;
+    IndexedHeap<Latest> byLatest;
+    Clock::time_point armed;
+    unsigned long long programmed;
+};
+
+#include "timer_queue.hxx"
+#endif
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  An id is the slot in its low 32 bits and the slot's generation in its
+ *  high bits. A slot's generation is bumped whenever its timer fires or is
+ *  cancelled, so an id that outlived its timer never cancels the slot's
+ *  next occupant.
+ *  </p>
+ *
+ *  <p>
+ *  A zero it_value disarms a timerfd, so a deadline at or before the
+ *  clock's epoch is armed for one nanosecond past it, which has passed
+ *  already and fires at once. The epoch itself marks a disarmed timerfd in
+ *  armed.
+ *  </p>
+ */
+
+/**
+ *  @brief Creates the timerfd, non-blocking and close-on-exec.
+ */
+inline TimerQueue::TimerQueue() :
+  timer(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)),
+  queue(Deadline{&timers}), byLatest(Latest{&timers}), programmed(0)
+{
+  if(timer < 0)
+  {
+    throw std::system_error(errno, std::system_category(), "timerfd_create");
+  }
+}
+
+/**
+ *  @brief Closes the timerfd, dropping pending timers without running them.
+ */
+inline TimerQueue::~TimerQueue()
+{
+  close(timer);
+}
+
+/**
+ *  @brief Returns the timerfd, readable once the earliest timer is due.
+ */
+inline int TimerQueue::fd() const noexcept
+{
+  return timer;
+}
+
+/**
+ *  @brief Returns the number of pending timers.
+ */
+inline size_t TimerQueue::size() const noexcept
+{
+  return queue.size();
+}
+
+/**
+ *  @brief Returns the time of the next wakeup, the earliest time a timer
+ *  must run by. This is the earliest deadline unless timers have slack.
+ *
+ *  Precondition:\n
+ *    size() > 0
+ */
+inline TimerQueue::Clock::time_point TimerQueue::next() const noexcept
+{
+  return timers[byLatest.top()].latest;
+}
+
+/**
+ *  @brief Adds a timer, reprogramming the timerfd only if it is now the
+ *  earliest.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size().
+ *
+ *  @param deadline time the callback is due.
+ *  @param callback run by the fire() call that finds the timer due.
+ *  @return id to cancel the timer with.
+ */
+inline TimerQueue::Id TimerQueue::add(Clock::time_point deadline,
+  std::function<void()> callback)
+{
+  return add(deadline, Clock::duration::zero(), std::move(callback));
+}
+
+/**
+ *  @brief Adds a timer that may run up to slack after its deadline,
+ *  reprogramming the timerfd only if it now bounds the next wakeup.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size().
+ *
+ *  @param deadline time before which the callback must not run.
+ *  @param slack how late after deadline the callback may run, at least 0.
+ *  @param callback run by the first fire() call after the deadline.
+ *  @return id to cancel the timer with.
+ */
+inline TimerQueue::Id TimerQueue::add(Clock::time_point deadline,
+  Clock::duration slack, std::function<void()> callback)
+{
+  unsigned slot;
+  if(unused.empty())
+  {
+    slot = timers.size();
+    timers.push_back(Timer{deadline, deadline + slack, std::move(callback),
+      0});
+  }
+  else
+  {
+    slot = unused.back();
+    unused.pop_back();
+    timers[slot].deadline = deadline;
+    timers[slot].latest = deadline + slack;
+    timers[slot].callback = std::move(callback);
+  }
+  queue.push(slot);
+  byLatest.push(slot);
+  arm();
+  return (Id)timers[slot].generation << 040 | slot;
+}
+
+/**
+ *  @brief Cancels a pending timer, reprogramming the timerfd only if it was
+ *  the earliest.
+ *
+ *  Complexity:\n
+ *    O(log(n)) where n is size().
+ *
+ *  @param id returned by add().
+ *  @return false if the timer already fired or was cancelled.
+ */
+inline bool TimerQueue::cancel(Id id)
+{
+  unsigned slot = (unsigned)id;
+  if(slot >= timers.size() || timers[slot].generation != id >> 040 ||
+    !queue.contains(slot))
+  {
+    return false;
+  }
+  queue.erase(slot);
+  byLatest.erase(slot);
+  ++timers[slot].generation;
+  timers[slot].callback = nullptr;
+  unused.push_back(slot);
+  arm();
+  return true;
+}
+
+/**
+ *  @brief Runs every timer whose deadline has passed, earliest first, then
+ *  rearms the timerfd for the next wakeup.
+ *
+ *  With slack this also runs timers that could have waited, since running
+ *  them now saves a later wakeup.
+ *
+ *  The timerfd is drained first, so a loop using level-triggered epoll is
+ *  not woken again for the same expiry. Timers added by the callbacks are
+ *  not run by this call even if already due, the rearmed timerfd reports
+ *  them at once.
+ *
+ *  Complexity:\n
+ *    O(k log(n)) plus the callbacks, where k timers are due and n is size().
+ *
+ *  @return the number of timers run.
+ */
+inline size_t TimerQueue::fire()
+{
+  uint64_t expirations;
+  while(read(timer, &expirations, sizeof(expirations)) < 0 && errno == EINTR)
+  {
+  }
+
+  Clock::time_point now = Clock::now();
+  std::vector<std::function<void()> > callbacks;
+  while(queue.size() != 0 && timers[queue.top()].deadline <= now)
+  {
+    unsigned slot = queue.pop();
+    byLatest.erase(slot);
+    callbacks.push_back(std::move(timers[slot].callback));
+    timers[slot].callback = nullptr;
+    ++timers[slot].generation;
+    unused.push_back(slot);
+  }
+  arm();
+  for(size_t i = 0; i < callbacks.size(); ++i)
+  {
+    callbacks[i]();
+  }
+  return callbacks.size();
+}
+
+/**
+ *  @brief Returns how often the timerfd was reprogrammed, which only
+ *  happens when the earliest deadline changes.
+ */
+inline unsigned long long TimerQueue::reprograms() const noexcept
+{
+  return programmed;
+}
+
+/**
+ *  @brief Program the timerfd for the next wakeup, or disarm it when there
+ *  are no timers, unless it already is.
+ */
+inline void TimerQueue::arm()
+{
+  Clock::time_point at;
+  if(queue.size() != 0)
+  {
+    at = std::max(next(), Clock::time_point(std::chrono::nanoseconds(01)));
+  }
+  if(at == armed)
+  {
+    return;
+  }
+  itimerspec spec = {};
+  if(queue.size() != 0)
+  {
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      at.time_since_epoch()).count();
+    spec.it_value.tv_sec = ns / 1000000000;
+    spec.it_value.tv_nsec = ns % 1000000000;
+  }
+  timerfd_settime(timer, TFD_TIMER_ABSTIME, &spec, NULL);
+  armed = at;
+  ++programmed;
+}
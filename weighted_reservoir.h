@@ -0,0 +1,103 @@
+#ifndef WEIGHTED_RESERVOIR_H
+#define WEIGHTED_RESERVOIR_H
+#include <random>
+#include <vector>
+#include "bounded_heap.h"
+
+/**
+ *  WeightedReservoir class draws a weighted random sample without
+ *  replacement of k items from a stream of unknown length in one pass,
+ *  following Efraimidis and Spirakis.
+ *
+ *  <p>
+ *  Every item gets the key u^(1/w), u uniform in (0, 1) and w its weight,
+ *  and the sample is the k items of largest key (A-Res). Keys are kept as
+ *  log(u)/w, which orders the same but does not underflow for small
+ *  weights, in a BoundedHeap whose worst entry is the least key, the
+ *  threshold T an item must beat.
+ *  </p>
+ *
+ *  <p>
+ *  Once the reservoir is full, most items cannot beat T, so instead of
+ *  drawing a key per item, the weight to skip before the next item that
+ *  does is drawn at once, as log(r)/log(T) (A-ExpJ). Skipped items cost an
+ *  addition and a comparison. Only the item that ends the jump gets a key,
+ *  drawn conditioned on beating T, and enters the heap. Over n items of
+ *  similar weight that is O(k log(n/k)) heap operations and random draws
+ *  instead of n.
+ *  </p>
+ *
+ *  <p>
+ *  Keys are independent per item, so reservoirs filled by different
+ *  threads over different parts of a stream merge into a sample of the
+ *  whole by keeping the k largest keys of both. Seed each one differently.
+ *  </p>
+ *
+ *  Template Parameters:\n
+ *    T Type of the items sampled.
+ *
+ *  Member Variables:\n
+ *    heap BoundedHeap of the sampled items by key.
+ *    random the generator.
+ *    jump weight left to skip before the next item enters.
+ *    seen total weight offered.
+ *    entered number of items that entered the heap.
+ *
+ *  Member Functions:
+ *  <p>
+ *    - (Constructor) take the sample size and a seed.
+ *    - size() return the number of items sampled so far.
+ *    - capacity() return the sample size.
+ *    - totalWeight() return the total weight offered.
+ *    - entries() return how many items entered the heap, skipped ones did
+ *        not.
+ *    - offer() offer an item of the stream with its weight.
+ *    - merge() fold in a reservoir sampled over another part of the
+ *        stream.
+ *    - sample() copy the sampled items, largest key first.
+ *    - uniform() private helper draw from the open interval (0, 1).
+ *    - draw() private helper draw the next jump.
+ *  </p>
+ */
+template <class T>
+class WeightedReservoir
+{
+  public:
+    explicit WeightedReservoir(size_t, unsigned long long = 0);
+    size_t size() const noexcept;
+    size_t capacity() const noexcept;
+    double totalWeight() const noexcept;
+    unsigned long long entries() const noexcept;
+    void offer(const T &, double);
+    void merge(const WeightedReservoir &);
+    void sample(std::vector<T> &) const;
+
+  private:
+    /**
+     *  Entry is a sampled item with the log of its key.
+     */
+    struct Entry
+    {
+      double key;
+      T item;
+    };
+
+    /**
+     *  Larger ranks entries by descending key, so the BoundedHeap keeps the
+     *  largest keys and its worst entry has the least.
+     */
+    struct Larger
+    {
+      double operator()(const Entry &e) const noexcept { return -e.key; }
+    };
+    double uniform();
+    void draw();
+    BoundedHeap<Entry, Larger> heap;
+    std::mt19937_64 random;
+    double jump;
+    double seen;
+    unsigned long long entered;
+};
+
+#include "weighted_reservoir.hxx"
+#endif
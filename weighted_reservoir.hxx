@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+
+/**
+ *  Implementation Notes:
+ *  <p>
+ *  With L = log(T) < 0, an item of weight w beats T with probability
+ *  1 - T^w, so the weight skipped before one does is exponential with rate
+ *  -L, and the jump is log(r)/L for r uniform in (0, 1). The item ending
+ *  the jump gets log(u)/w with u uniform in (T^w, 1). A new jump is drawn
+ *  whenever the threshold changes, which is valid since jumps are
+ *  memoryless.
+ *  </p>
+ */
+
+/**
+ *  @brief Constructs an empty reservoir.
+ *
+ *  @tparam T type of the items sampled.
+ *  @param k the sample size.
+ *  @param seed seed of the generator.
+ */
+template <class T>
+WeightedReservoir<T>::WeightedReservoir(size_t k, unsigned long long seed) :
+  heap(k), random(seed), jump(0), seen(0), entered(0)
+{
+}
+
+/**
+ *  @brief Returns the number of items sampled so far.
+ *
+ *  @tparam T type of the items sampled.
+ */
+template <class T>
+size_t WeightedReservoir<T>::size() const noexcept
+{
+  return heap.size();
+}
+
+/**
+ *  @brief Returns the sample size.
+ *
+ *  @tparam T type of the items sampled.
+ */
+template <class T>
+size_t WeightedReservoir<T>::capacity() const noexcept
+{
+  return heap.limit();
+}
+
+/**
+ *  @brief Returns the total weight offered, including merged reservoirs.
+ *
+ *  @tparam T type of the items sampled.
+ */
+template <class T>
+double WeightedReservoir<T>::totalWeight() const noexcept
+{
+  return seen;
+}
+
+/**
+ *  @brief Returns how many items entered the heap. The others were skipped
+ *  without drawing a key.
+ *
+ *  @tparam T type of the items sampled.
+ */
+template <class T>
+unsigned long long WeightedReservoir<T>::entries() const noexcept
+{
+  return entered;
+}
+
+/**
+ *  @brief Offers the next item of the stream.
+ *
+ *  Complexity:\n
+ *    Constant for a skipped item, O(log(k)) for one entering the sample.
+ *
+ *  @tparam T type of the items sampled.
+ *  @param item the item, copied if it enters the sample.
+ *  @param weight its weight, items of weight 0 are never sampled.
+ */
+template <class T>
+void WeightedReservoir<T>::offer(const T &item, double weight)
+{
+  if(!(weight > 0) || capacity() == 0)
+  {
+    return;
+  }
+  seen += weight;
+  Entry e = {0, item};
+  if(!heap.full())
+  {
+    e.key = std::log(uniform()) / weight;
+  }
+  else
+  {
+    jump -= weight;
+    if(jump > 0)
+    {
+      return;
+    }
+    double t = std::exp(weight * heap.worst().key);
+    e.key = std::log(t + (1 - t) * uniform()) / weight;
+    if(!heap.accepts(e))
+    {
+      draw(); //rounded down to the threshold
+      return;
+    }
+  }
+  heap.offer(e);
+  ++entered;
+  if(heap.full())
+  {
+    draw();
+  }
+}
+
+/**
+ *  @brief Folds in a reservoir sampled over another part of the stream,
+ *  e.g. by another thread, making this a sample of both parts.
+ *
+ *  Complexity:\n
+ *    O(k log(k)) where k is capacity().
+ *
+ *  Precondition:\n
+ *    other.capacity() == capacity()
+ *
+ *  @tparam T type of the items sampled.
+ *  @param other the other reservoir, unchanged.
+ */
+template <class T>
+void WeightedReservoir<T>::merge(const WeightedReservoir &other)
+{
+  heap.merge(other.heap);
+  seen += other.seen;
+  entered += other.entered;
+  if(heap.full())
+  {
+    draw();
+  }
+}
+
+/**
+ *  @brief Copies the sampled items, largest key first.
+ *
+ *  @tparam T type of the items sampled.
+ *  @param out replaced by the items.
+ */
+template <class T>
+void WeightedReservoir<T>::sample(std::vector<T> &out) const
+{
+  std::vector<Entry> entries(heap.begin(), heap.end());
+  std::sort(entries.begin(), entries.end(),
+    [](const Entry &a, const Entry &b) { return b.key < a.key; });
+  out.clear();
+  for(size_t i = 0; i < entries.size(); ++i)
+  {
+    out.push_back(entries[i].item);
+  }
+}
+
+/**
+ *  @brief Draw from the open interval (0, 1), 53 random bits.
+ *
+ *  @tparam T type of the items sampled.
+ */
+template <class T>
+double WeightedReservoir<T>::uniform()
+{
+  return ((random() >> 013) + 0.5) / 9007199254740992.0;
+}
+
+/**
+ *  @brief Draw the weight to skip before the next item beating the
+ *  threshold.
+ *
+ *  @tparam T type of the items sampled.
+ */
+template <class T>
+void WeightedReservoir<T>::draw()
+{
+  jump = std::log(uniform()) / heap.worst().key;
+}